@@ -7,155 +7,201 @@
 #include "STC8H.h"
 #include "bsp_adc.h"
 #include "bsp_delay.h"
+#include "spsc_queue.h"
 
-// ADC采样值存储
-static data volatile uint16_t adc_raw_values[3] = {0, 0, 0};
-
-// ADC控制结构体
-typedef struct {
-    uint16_t temp_values[4][3];  // 临时采样数组，4轮×3通道
-    uint8_t  round;             // 当前采样轮次
-    uint8_t  channel;           // 当前采样通道
-    uint8_t  converting;        // 转换完成标志
-} adc_control_t;
-
-static data adc_control_t adc_ctrl = {0};
-
-// ADC通道映射表，方便根据枚举获取对应的ADC通道号
+// ADC通道映射表（扫描通道表），扫描顺序即表中顺序，增删通道只需同步修改adc_channel_t枚举
 static data const uint8_t adc_channel_mapping[MAX_ADC_CHANNEL] = {
     BAND_SWITCH_1,  // BAND_K1_ADC_CHANNEL
     BAND_SWITCH_2,  // BAND_K2_ADC_CHANNEL
-    POWER_SWITCH   // POWER_ADC_CHANNEL
+    POWER_SWITCH,  // POWER_ADC_CHANNEL
+    BANDGAP_REF    // BANDGAP_ADC_CHANNEL
 };
 
-// 保存 ADC 中断使能状态
-static data uint8_t adc_ie_backup;
+// 一轮扫描的抽取结果
+typedef struct {
+    uint16_t value[MAX_ADC_CHANNEL];
+} adc_frame_t;
 
-/**
- * @brief 进入ADC临界区（仅关闭ADC中断，不影响其他中断）
- */
-static void adc_enter_critical(void) {
-    adc_ie_backup = EADC;  // 保存当前ADC中断状态
-    EADC = 0;  // 关闭ADC中断
-}
+// 抽取结果队列：中断直接填写写入槽位，全部通道抽取完成后发布；任务侧取出最新一轮，无需关中断
+static xdata SPSC_QUEUE(adc_frame_t, ADC_FRAME_QUEUE_SIZE) adc_queue;
+static xdata adc_frame_t adc_latest;   // 任务侧最新一轮抽取结果
+static data uint8_t adc_seq = 0;       // 任务侧取出的轮数，0表示尚无有效数据
+static data volatile uint8_t adc_dropped = 0;  // 队列满丢弃的轮数（任务长时间未读取）
 
-/**
- * @brief 退出ADC临界区（恢复ADC中断状态）
- */
-static void adc_exit_critical(void) {
-    EADC = adc_ie_backup;  // 恢复之前保存的ADC中断状态
-}
+// 每通道过采样累加状态
+typedef struct {
+    uint16_t sum;    // 过采样累加和，16×1023 < 65536
+    uint8_t  count;  // 抽取计数
+} adc_accum_t;
+
+static data adc_accum_t adc_accum[MAX_ADC_CHANNEL];
+static data uint8_t adc_scan_idx = 0;  // 当前转换的通道表索引
+#if ADC_PWM_TRIGGER
+static data uint8_t adc_burst_cnt = 0;  // 本次PWM触发已完成的转换数
+#endif
+
+// BandGap校准数据（仅任务侧访问）
+uint16_t adc_bgv_mv = ADC_BGV_DEFAULT_MV;                       // 出厂BandGap电压值，main()第一条语句读入
+static uint16_t adc_cal_factor = 1U << ADC_CAL_Q;               // 校准系数，Q15，实测VREF/标称VREF
+static uint16_t adc_vref_mv = ADC_VREF_NOMINAL_MV;              // 实测参考电压
+static uint8_t adc_cal_seq = 0;                                 // 上次校准时的缓冲切换序号
 
 // ADC 初始化
 void adc_init(void) {
     ADCCFG = ADC_CFG_ALIGN_RIGHT | ADC_CFG_CLK_DIV_16;  // 结果右对齐，时钟为16分频：SYSclk/2/16
+#if ADC_PWM_TRIGGER
+    ADC_CONTR = ADC_CONTR_ADIE | ADC_CONTR_EPWMT;        // 使能 ADC 模块，转换由PWMB触发
+#else
     ADC_CONTR = ADC_CONTR_ADIE;                          // 使能 ADC 模块
+#endif
     EADC = 1;                                            // 使能 ADC 中断
 
+    // 出厂BandGap电压值已在main()入口读取（之后idata高地址可能被堆栈覆盖），这里只检查范围
+    if (adc_bgv_mv < ADC_BGV_MIN_MV || adc_bgv_mv > ADC_BGV_MAX_MV) {
+        adc_bgv_mv = ADC_BGV_DEFAULT_MV;
+    }
+
     delay_ms(10);  // 延时等待电源稳定
 }
 
-// 转换 ADC 采样值为电压值，单位：mV
+/**
+ * @brief 取出队列中的全部抽取结果，保留最新一轮
+ * @note 仅在任务上下文调用（队列的唯一消费者）
+ */
+static void adc_poll(void) {
+    while (SPSC_POP(adc_queue, adc_latest)) {
+        if (++adc_seq == 0) {
+            adc_seq = 1;  // 0保留为无有效数据
+        }
+    }
+}
+
+// 转换校准后的 ADC 值为电压值，单位：mV
 uint16_t adc_to_voltage(uint16_t adc_val) {
-    // 5V reference voltage, 10-bit ADC
-    return (uint16_t)((uint32_t)adc_val * 5000 / ADC_RESOLUTION);
+    // 5000 / 4096 = 625 / 512
+    return (uint16_t)(((uint32_t)adc_val * 625) >> 9);
 }
 
-// 启动一轮ADC转换：4轮，每轮3个通道依次转换
-void adc_start_conversion(uint8_t is_enforce) {
-    uint8_t i, j;
-    uint8_t need_start = 1;  // 标记是否需要启动转换
-
-    // 核心修正：所有对converting的读/写都包在临界区
-    adc_enter_critical();
-    if (!is_enforce) {
-        // 非强制模式：检查是否正在转换
-        if (adc_ctrl.converting) {
-            need_start = 0;  // 正在转换，无需启动
-        } else {
-            // 不在转换中，初始化控制参数
-            adc_ctrl.round = 0;
-            adc_ctrl.channel = 0;
-            adc_ctrl.converting = 1;
-        }
-    } else {
-        // 强制模式：不管是否在转换，都重置参数
-        adc_ctrl.round = 0;
-        adc_ctrl.channel = 0;
-        adc_ctrl.converting = 1;
+// 根据最新的BandGap采样值更新校准系数
+void adc_calibrate(void) {
+    uint16_t bg_code;
+    uint32_t factor;
+
+    adc_poll();
+    if (adc_seq == adc_cal_seq) {
+        return;  // 没有新的抽取数据
     }
-    adc_exit_critical();
 
-    // 如果不需要启动，直接返回
-    if (!need_start) {
+    bg_code = adc_get_raw_value(BANDGAP_ADC_CHANNEL);
+    if (bg_code == ADC_NOT_READY || bg_code == 0) {
         return;
     }
+    adc_cal_seq = adc_seq;
 
-    // 清零临时数组
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 3; j++) {
-            adc_ctrl.temp_values[i][j] = 0;
-        }
+    // 实测VREF = BGV × 4096 / bg_code，系数 = 实测VREF / 5000，Q15
+    factor = (uint32_t)adc_bgv_mv * ADC_CAL_K / bg_code;
+    if (factor > 0xFFFF) {
+        return;  // BandGap读数异常偏低（VREF接近10V），保留上次系数
     }
+    adc_cal_factor = (uint16_t)factor;
+    adc_vref_mv = (uint16_t)(((uint32_t)adc_bgv_mv << 12) / bg_code);
+}
 
-    // 启动第1轮第1个通道转换
-    EADC = 1;  // 开启ADC中断
-    ADC_CONTR &= ~ADC_CONTR_CH_MASK;                      // 清除通道选择位
-    ADC_CONTR |= adc_channel_mapping[adc_ctrl.channel];  // 设置通道
+// 获取校准后的ADC值
+uint16_t adc_get_calibrated_value(adc_channel_t channel) {
+    uint16_t raw = adc_get_raw_value(channel);
+
+    if (raw == ADC_NOT_READY) {
+        return ADC_NOT_READY;
+    }
+    return (uint16_t)(((uint32_t)raw * adc_cal_factor) >> ADC_CAL_Q);
+}
+
+// 获取实测的ADC参考电压
+uint16_t adc_get_vref(void) {
+    return adc_vref_mv;
+}
+
+// 启动连续扫描
+void adc_scan_start(void) {
+    uint8_t i;
+
+    EADC = 0;
+    SPSC_INIT(adc_queue);
+    for (i = 0; i < MAX_ADC_CHANNEL; i++) {
+        adc_accum[i].sum = 0;
+        adc_accum[i].count = 0;
+    }
+    adc_scan_idx = 0;
+#if ADC_PWM_TRIGGER
+    adc_burst_cnt = 0;
+#endif
+
+    // 选择第1个通道，之后由中断循环选择下一通道
+    ADC_CONTR &= ~(ADC_CONTR_FLAG | ADC_CONTR_CH_MASK);  // 清除完成标志和通道选择位
+    ADC_CONTR |= adc_channel_mapping[0];                  // 设置通道
+    EADC = 1;                                             // 开启ADC中断
+#if !ADC_PWM_TRIGGER
     ADC_CONTR |= ADC_CONTR_START;                         // 启动转换
+#endif
 }
 
-// 获取ADC转换完成的raw值，转换完成返回值，未完成返回ADC_NOT_READY
+// 获取最近一次抽取完成的过采样值，尚无有效数据返回ADC_NOT_READY
 uint16_t adc_get_raw_value(adc_channel_t channel) {
-    uint16_t value;
+    adc_poll();
+    return (adc_seq == 0) ? ADC_NOT_READY : adc_latest.value[channel];
+}
 
-    adc_enter_critical();  // 进入ADC临界区，确保读取过程中ADC中断不会修改数据
-    if (adc_ctrl.converting) {
-        value = ADC_NOT_READY;
-    } else {
-        value = adc_raw_values[channel];
-    }
-    adc_exit_critical();  // 退出ADC临界区，恢复ADC中断状态
-    return value;
+// 获取抽取轮数序号
+uint8_t adc_get_seq(void) {
+    adc_poll();
+    return adc_seq;
+}
+
+// 获取队列满丢弃的轮数
+uint8_t adc_get_dropped(void) {
+    return adc_dropped;
 }
 
 // ADC 中断服务函数
 void adc_Isr(void) interrupt 5 {
     if (ADC_CONTR & ADC_CONTR_FLAG) {
-        // 读取ADC结果
-        uint16_t adc_result = ((uint16_t)ADC_RES << 8) | ADC_RESL;
+        uint8_t idx = adc_scan_idx;
 
-        // 保存采样值(只保留10位有效值)
-        adc_ctrl.temp_values[adc_ctrl.round][adc_ctrl.channel] = adc_result & 0x03FF;
+        // 读取ADC结果(只保留10位有效值)并累加
+        adc_accum[idx].sum += (((uint16_t)ADC_RES << 8) | ADC_RESL) & 0x03FF;
 
-        // 转换下一个通道
-        adc_ctrl.channel++;
-        if (adc_ctrl.channel >= MAX_ADC_CHANNEL) {
-            adc_ctrl.channel = 0;
-            adc_ctrl.round++;
-        }
+        // 抽取：累加满ADC_OVERSAMPLE_CNT次，输出12位值到队列写入槽位（消费者不会读到未发布的槽位）
+        if (++adc_accum[idx].count >= ADC_OVERSAMPLE_CNT) {
+            SPSC_SLOT(adc_queue).value[idx] = adc_accum[idx].sum >> ADC_OVERSAMPLE_SHIFT;
+            adc_accum[idx].sum = 0;
+            adc_accum[idx].count = 0;
 
-        // 检查是否完成4轮转换
-        if (adc_ctrl.round >= 4) {
-            uint8_t i, j;
-            uint32_t sum;
-            // 计算各通道平均值
-            for (i = 0; i < MAX_ADC_CHANNEL; i++) {
-                sum = 0;
-                for (j = 0; j < 4; j++) {
-                    sum += adc_ctrl.temp_values[j][i];
+            // 通道表最后一个通道抽取完成，发布这一轮；队列满时丢弃，槽位下一轮重新填写
+            if (idx == MAX_ADC_CHANNEL - 1 && !SPSC_COMMIT(adc_queue)) {
+                if (adc_dropped < 0xFF) {
+                    adc_dropped++;
                 }
-                adc_raw_values[i] = (uint16_t)(sum >> 2);
             }
-            adc_ctrl.converting = 0;
-            EADC = 0;  // 关闭ADC中断，避免数据未处理再进中断
-        } else {
-            // 启动下一个通道转换
-            ADC_CONTR &= ~ADC_CONTR_CH_MASK;                      // 清除通道选择位
-            ADC_CONTR |= adc_channel_mapping[adc_ctrl.channel];  // 设置通道
-            ADC_CONTR |= ADC_CONTR_START;                         // 启动转换
         }
 
-        ADC_CONTR &= ~ADC_CONTR_FLAG;  // 清除中断标志位
+        // 转换下一个通道
+        if (++idx >= MAX_ADC_CHANNEL) {
+            idx = 0;
+        }
+        adc_scan_idx = idx;
+
+        ADC_CONTR &= ~(ADC_CONTR_FLAG | ADC_CONTR_CH_MASK);  // 清除中断标志位和通道选择位
+        ADC_CONTR |= adc_channel_mapping[idx];               // 设置通道
+#if ADC_PWM_TRIGGER
+        // PWM触发模式：一次触发连续转换一整轮通道表，之后等待下一次PWMB触发
+        if (++adc_burst_cnt < ADC_TRIG_BURST) {
+            ADC_CONTR |= ADC_CONTR_START;
+        } else {
+            adc_burst_cnt = 0;
+        }
+#else
+        ADC_CONTR |= ADC_CONTR_START;                        // 启动转换
+#endif
     }
 }
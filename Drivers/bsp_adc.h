@@ -15,6 +15,7 @@
 #define ADC_CONTR_ADIE   0x80   // ADC中断使能位
 #define ADC_CONTR_START  0x40   // ADC转换启动位
 #define ADC_CONTR_FLAG   0x20   // ADC转换完成标志位
+#define ADC_CONTR_EPWMT  0x10   // PWM触发ADC使能位
 #define ADC_CONTR_CH_MASK 0x0F  // ADC通道选择掩码
 
 #define ADC_CFG_ALIGN_RIGHT 0x20   // 结果右对齐 (bit5=1)
@@ -22,7 +23,34 @@
 #define ADC_CFG_CLK_DIV_16  0x0F   // 时钟16分频
 
 // ADC配置常量
-#define ADC_RESOLUTION 1024  // 10位ADC分辨率
+#define ADC_HW_BITS 10                 // ADC硬件分辨率10位
+#define ADC_OVERSAMPLE_CNT 16          // 每通道过采样次数，4^2次过采样提升2位分辨率
+#define ADC_OVERSAMPLE_SHIFT 2         // 累加和右移位数：16次累加(14位)右移2位得到12位
+#define ADC_RESOLUTION 4096            // 过采样后12位有效分辨率
+#define ADC_VREF_NOMINAL_MV 5000       // 标称参考电压(VCC)，单位：mV
+#define ADC_FRAME_QUEUE_SIZE 4         // 抽取结果队列容量（2的幂），可缓存3轮
+
+// 转换时间：ADC时钟SYSclk/2/16，ADCTIM复位值0x2A（建立1+保持2+采样11个时钟）加10位逐次比较
+#define ADC_CONV_CLKS 24                                        // 一次转换的ADC时钟数
+#define ADC_CONV_US (ADC_CONV_CLKS * 2 * 16 / (FOSC / 1000000))  // 一次转换时间，32us
+
+// PWM触发：每次触发连续转换一整轮通道表，一轮抽取需ADC_OVERSAMPLE_CNT个PWM周期（16ms）
+#define ADC_TRIG_BURST MAX_ADC_CHANNEL                  // 每次触发的转换次数
+#define ADC_TRIG_BURST_US (ADC_TRIG_BURST * ADC_CONV_US)  // 一次触发的连续转换时长，128us
+
+// BandGap校准配置
+#ifndef ADC_BGV_IDATA_ADDR             // 仿真器编译时预先定义为仿真出厂值的地址
+#define ADC_BGV_IDATA_ADDR 0xEF        // 出厂BandGap电压值(mV)在idata中的存放地址，高字节在前
+#endif
+#define ADC_BGV_DEFAULT_MV 1190        // 出厂值无效时使用的BandGap典型值
+#define ADC_BGV_MIN_MV 1000            // 出厂值合法下限
+#define ADC_BGV_MAX_MV 1400            // 出厂值合法上限
+#define ADC_CAL_Q 15                   // 校准系数定点位数，系数1.0 = 1<<15
+#define ADC_CAL_K (((1UL << 27) + ADC_VREF_NOMINAL_MV / 2) / ADC_VREF_NOMINAL_MV)  // 2^(15+12)/5000
+
+// 出厂BandGap电压值(mV)：main()第一条语句从ADC_BGV_IDATA_ADDR读入，早于任何会使用堆栈的调用链，
+// adc_init()中超出ADC_BGV_MIN_MV~ADC_BGV_MAX_MV时改用ADC_BGV_DEFAULT_MV
+extern uint16_t adc_bgv_mv;
 
 // ADC通道枚举定义
 typedef enum
@@ -30,6 +58,7 @@ typedef enum
     BAND_K1_ADC_CHANNEL = 0,
     BAND_K2_ADC_CHANNEL,
     POWER_ADC_CHANNEL,
+    BANDGAP_ADC_CHANNEL,
     MAX_ADC_CHANNEL
 } adc_channel_t;
 
@@ -42,28 +71,67 @@ typedef enum
 void adc_init(void);
 
 /**
- * @brief 转换 ADC 采样值为电压值，单位：mV
+ * @brief 转换校准后的 ADC 值为电压值，单位：mV
+ * @note 仅移位和乘法，无除法：mV = val × 5000 / 4096 = val × 625 >> 9
  *
- * @param adc_val ADC采样值
+ * @param adc_val 校准后的ADC值（adc_get_calibrated_value的返回值）
  * @return uint16_t 转换后的电压值，单位：mV
  */
 uint16_t adc_to_voltage(uint16_t adc_val);
 
 /**
- * @brief 启动一轮ADC转换：4轮，每轮3个通道依次转换
- * @param is_enforce
- * 是否强制启动转换，如果为1则无论当前状态如何都重新启动转换；如果为0则仅在当前未转换或转换完成时启动转换
+ * @brief 根据最新的BandGap采样值更新校准系数
+ * @note 仅在有新的抽取数据时做一次除法，需在任务中周期调用
+ */
+void adc_calibrate(void);
+
+/**
+ * @brief 获取校准后的ADC值：按实测参考电压折算到标称5V参考下的12位值
+ *
+ * @param channel ADC通道枚举
+ * @return uint16_t 校准后的ADC值；如果尚无有效数据则返回ADC_NOT_READY
+ */
+uint16_t adc_get_calibrated_value(adc_channel_t channel);
+
+/**
+ * @brief 获取实测的ADC参考电压(VCC)
+ *
+ * @return uint16_t 参考电压，单位：mV
+ */
+uint16_t adc_get_vref(void);
+
+/**
+ * @brief 启动连续扫描：按通道表循环转换，每个通道累加ADC_OVERSAMPLE_CNT次后抽取为12位值
+ * @note 启动后由中断自行连续运行，任务侧无需重新触发；
+ *       ADC_PWM_TRIGGER为1时每个PWM周期在输出安静点由PWMB硬件触发，中断内连续转换一整轮通道表，
+ *       每1ms每个通道一次采样，抽取一轮（adc_get_seq加1）需16ms；为0时连续转换，一轮约2ms
  */
-void adc_start_conversion(uint8_t is_enforce);
+void adc_scan_start(void);
 
 /**
- * @brief 获取ADC转换完成的raw值，转换完成返回值，未完成返回ADC_NOT_READY
+ * @brief 获取最近一次抽取完成的12位过采样值，首次抽取完成前返回ADC_NOT_READY
+ * @note 仅在任务上下文调用：调用时从队列取出新的抽取结果，不关ADC中断
  *
  * @param channel ADC通道枚举
- * @return uint16_t ADC采样原始值，单位：0-1023；如果转换未完成则返回ADC_NOT_READY
+ * @return uint16_t ADC过采样值，单位：0-4095；如果尚无有效数据则返回ADC_NOT_READY
  */
 uint16_t adc_get_raw_value(adc_channel_t channel);
 
+/**
+ * @brief 获取抽取轮数序号，任务侧每取到一轮全部通道的抽取结果加1
+ * @note 任务侧比较前后两次序号即可判断是否有新的采样数据，0表示尚无有效数据
+ *
+ * @return uint8_t 抽取轮数序号
+ */
+uint8_t adc_get_seq(void);
+
+/**
+ * @brief 获取抽取结果队列满时丢弃的轮数
+ *
+ * @return uint8_t 丢弃轮数，饱和于255
+ */
+uint8_t adc_get_dropped(void);
+
 /**
  * @brief ADC转换完成中断服务函数
  */
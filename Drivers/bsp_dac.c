@@ -0,0 +1,116 @@
+/**
+ * @file bsp_dac.c
+ * @brief 外部I2C DAC驱动实现
+ *
+ * @date 2026-02-07
+ */
+#include "STC8H.h"
+#include "bsp_dac.h"
+#include "bsp_i2c.h"
+
+#if I2C_ENABLE
+
+#if DAC_TYPE == DAC_MCP4725
+#define DAC_XFER_CNT DAC_CHANNELS  // 每片一个传输请求
+#else
+#define DAC_XFER_CNT 1             // 一次快速写更新全部通道
+#endif
+
+static xdata i2c_xfer_t dac_xfer[DAC_XFER_CNT];  // 传输请求，排队期间由I2C中断访问
+static xdata uint16_t dac_code[DAC_CHANNELS];    // 目标码值
+static data uint8_t dac_dirty;                   // 码值已变化、尚未发送的传输请求，按位
+static data uint8_t dac_errors;                  // 应答失败次数
+
+// DAC初始化
+void dac_init(void) {
+    uint8_t i;
+
+    for (i = 0; i < DAC_CHANNELS; i++) {
+        dac_code[i] = 0;
+    }
+    for (i = 0; i < DAC_XFER_CNT; i++) {
+        dac_xfer[i].status = I2C_XFER_IDLE;
+    }
+    dac_dirty = (1 << DAC_XFER_CNT) - 1;  // 上电先写一次，使DAC与RAM一致
+    dac_errors = 0;
+}
+
+// 设置通道输出码值
+void dac_write(uint8_t ch, uint16_t value) {
+    if (ch >= DAC_CHANNELS) {
+        return;
+    }
+    if (value > DAC_CODE_MAX) {
+        value = DAC_CODE_MAX;
+    }
+    if (value != dac_code[ch]) {
+        dac_code[ch] = value;
+#if DAC_TYPE == DAC_MCP4725
+        dac_dirty |= 1 << ch;
+#else
+        dac_dirty |= 0x01;
+#endif
+    }
+}
+
+/**
+ * @brief 按当前码值填写传输请求
+ *
+ * @param n 传输请求索引
+ */
+static void dac_fill(uint8_t n) {
+    i2c_xfer_t xdata *x = &dac_xfer[n];
+
+#if DAC_TYPE == DAC_MCP4725
+    // 快速写：[0 0 PD1 PD0 D11~D8][D7~D0]，PD=00正常输出
+    x->addr = DAC_I2C_ADDR + n;
+    x->wr_len = 2;
+    x->wr_buf[0] = (uint8_t)(dac_code[n] >> 8) & 0x0F;
+    x->wr_buf[1] = (uint8_t)dac_code[n];
+#else
+    // 快速写：通道A~D依次各两字节，C、D输出0
+    uint8_t i;
+
+    x->addr = DAC_I2C_ADDR;
+    x->wr_len = 8;
+    for (i = 0; i < 4; i++) {
+        uint16_t value = (i < DAC_CHANNELS) ? dac_code[i] : 0;
+        x->wr_buf[i << 1] = (uint8_t)(value >> 8) & 0x0F;
+        x->wr_buf[(i << 1) + 1] = (uint8_t)value;
+    }
+    (void)n;
+#endif
+    x->rd_len = 0;
+}
+
+// 发送有变化的通道
+void dac_poll(void) {
+    uint8_t n;
+
+    for (n = 0; n < DAC_XFER_CNT; n++) {
+        if (dac_xfer[n].status == I2C_XFER_PENDING) {
+            continue;  // 上一次传输尚未完成，期间的写入在完成后合并发送
+        }
+        if (dac_xfer[n].status == I2C_XFER_NACK) {
+            if (dac_errors < 0xFF) {
+                dac_errors++;
+            }
+            dac_dirty |= 1 << n;  // 重发
+        }
+        dac_xfer[n].status = I2C_XFER_IDLE;
+
+        if (dac_dirty & (1 << n)) {
+            dac_fill(n);
+            if (i2c_submit(&dac_xfer[n])) {
+                dac_dirty &= ~(1 << n);
+            }
+        }
+    }
+}
+
+// 获取应答失败次数
+uint8_t dac_get_errors(void) {
+    return dac_errors;
+}
+
+#endif /* I2C_ENABLE */
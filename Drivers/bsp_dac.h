@@ -0,0 +1,54 @@
+/**
+ * @file bsp_dac.h
+ * @brief 外部I2C DAC驱动头文件，支持MCP4725（每通道一片）和MCP4728（一片四通道）
+ * @note 写入只更新RAM中的目标码值，由dac_poll在I2C空闲时把最新值一次发出：
+ *       传输期间的多次写入合并为一次，总线忙时不排队等待；应答失败时下次轮询重发。
+ *       MCP4728使用快速写命令写输入寄存器，LDAC需接地，写入后立即更新输出。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __BSP_DAC_H__
+#define __BSP_DAC_H__
+
+#include "gl08_config.h"
+
+#if I2C_ENABLE
+
+#define DAC_MCP4725 0  // 每通道一片MCP4725，地址DAC_I2C_ADDR、DAC_I2C_ADDR+1
+#define DAC_MCP4728 1  // 一片MCP4728，通道A、B对应D1、D2，C、D输出0
+
+#define DAC_TYPE DAC_MCP4725
+#define DAC_I2C_ADDR 0x60     // 7位地址（A0/A2~A0接地）
+#define DAC_CHANNELS 2        // 使用的DAC通道数，与输出通道一一对应
+#define DAC_CODE_MAX 4095     // 12位满量程
+
+/**
+ * @brief DAC初始化，所有通道置为待发送的0
+ * @note 需在i2c_init之后调用
+ */
+void dac_init(void);
+
+/**
+ * @brief 设置通道输出码值，只更新RAM，由dac_poll发送
+ *
+ * @param ch 通道索引（0、1）
+ * @param value 12位码值，超过DAC_CODE_MAX按满量程
+ */
+void dac_write(uint8_t ch, uint16_t value);
+
+/**
+ * @brief 发送有变化的通道：I2C空闲时提交一次传输，传输中的结果在下次调用时检查
+ * @note 在任务上下文中周期调用
+ */
+void dac_poll(void);
+
+/**
+ * @brief 获取应答失败次数
+ *
+ * @return uint8_t 失败次数，饱和于255
+ */
+uint8_t dac_get_errors(void);
+
+#endif /* I2C_ENABLE */
+
+#endif /* __BSP_DAC_H__ */
@@ -0,0 +1,63 @@
+/**
+ * @file bsp_eeprom.c
+ * @brief 内部EEPROM(IAP)模块实现
+ *
+ * @date 2026-02-07
+ */
+#include "bsp_eeprom.h"
+
+// 使能IAP并设置命令
+static void eeprom_enable(uint8_t cmd) {
+    IAP_TPS = IAP_TPS_VALUE;  // 设置等待时间
+    IAP_CONTR = IAPEN;        // 使能IAP
+    IAP_CMD = cmd;            // 设置IAP命令
+}
+
+// 关闭IAP，地址指向非EEPROM区，防止误操作
+static void eeprom_disable(void) {
+    IAP_CONTR = 0;
+    IAP_CMD = IAP_CMD_IDLE;
+    IAP_TRIG = 0;
+    IAP_ADDRH = 0xFF;
+    IAP_ADDRL = 0xFF;
+}
+
+// 触发IAP操作，CPU等待操作完成后继续执行
+static void eeprom_trigger(uint16_t addr) {
+    IAP_ADDRH = addr >> 8;
+    IAP_ADDRL = addr & 0xFF;
+
+    F0 = EA;  // 保存全局中断
+    EA = 0;   // 触发序列期间禁止中断，避免触发无效
+    IAP_TRIG = 0x5A;
+    IAP_TRIG = 0xA5;
+    _nop_();
+    _nop_();
+    EA = F0;  // 恢复全局中断
+}
+
+// 从EEPROM连续读出n个字节
+void eeprom_read(uint16_t addr, uint8_t *buf, uint16_t len) {
+    const uint8_t code *src = (const uint8_t code *)(EEPROM_MOVC_OFFSET + addr);
+
+    while (len--) {
+        *buf++ = *src++;
+    }
+}
+
+// 向EEPROM连续写入n个字节
+void eeprom_write(uint16_t addr, const uint8_t *buf, uint16_t len) {
+    eeprom_enable(IAP_CMD_WRITE);
+    while (len--) {
+        IAP_DATA = *buf++;
+        eeprom_trigger(addr++);
+    }
+    eeprom_disable();
+}
+
+// 擦除地址所在的扇区
+void eeprom_erase_sector(uint16_t addr) {
+    eeprom_enable(IAP_CMD_ERASE);
+    eeprom_trigger(addr);
+    eeprom_disable();
+}
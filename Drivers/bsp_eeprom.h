@@ -0,0 +1,60 @@
+/**
+ * @file bsp_eeprom.h
+ * @brief 内部EEPROM(IAP)模块头文件，实现扇区擦除和字节读写
+ * @note 参考Libaries/EEPROM.c，改为基于STC8H.h实现，便于与bsp层其他驱动共用头文件
+ *
+ * @date 2026-02-07
+ */
+#ifndef __BSP_EEPROM_H__
+#define __BSP_EEPROM_H__
+
+#include "STC8H.h"
+#include "type_def.h"
+#include "gl08_config.h"
+
+// EEPROM配置常量（STC8H1K08：4KB EEPROM，512字节/扇区）
+#define EEPROM_SIZE 4096                 // EEPROM总容量
+#define EEPROM_SECTOR_SIZE 512           // 扇区大小，擦除以扇区为单位
+#define EEPROM_SECTOR_ADDR(n) ((uint16_t)(n) * EEPROM_SECTOR_SIZE)  // 扇区首地址
+
+#ifndef EEPROM_MOVC_OFFSET  // 仿真器编译时预先定义为仿真EEPROM存储的地址
+#define EEPROM_MOVC_OFFSET 0x2000  // EEPROM在程序空间中的映射地址（8KB程序区之后），可用MOVC直接读取
+#endif
+
+// IAP命令定义
+#define IAP_CMD_IDLE 0   // 空操作
+#define IAP_CMD_READ 1   // 字节读
+#define IAP_CMD_WRITE 2  // 字节写
+#define IAP_CMD_ERASE 3  // 扇区擦除
+
+#define IAP_TPS_VALUE (FOSC / 1000000UL)  // IAP等待时间：系统时钟MHz数
+
+/**
+ * @brief 从EEPROM连续读出n个字节
+ * @note 通过MOVC读取映射区，不经过IAP触发，上电扫描时更快
+ *
+ * @param addr EEPROM起始地址（0-4095）
+ * @param buf 数据缓冲区
+ * @param len 读取长度
+ */
+void eeprom_read(uint16_t addr, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief 向EEPROM连续写入n个字节
+ * @note 只能把1写成0，写入前需先擦除所在扇区
+ *
+ * @param addr EEPROM起始地址（0-4095）
+ * @param buf 数据缓冲区
+ * @param len 写入长度
+ */
+void eeprom_write(uint16_t addr, const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief 擦除地址所在的扇区，擦除后全部字节为0xFF
+ * @note 擦除期间CPU停止运行约4ms，PWM等硬件外设不受影响
+ *
+ * @param addr 扇区内任意地址
+ */
+void eeprom_erase_sector(uint16_t addr);
+
+#endif /* __BSP_EEPROM_H__ */
@@ -0,0 +1,160 @@
+/**
+ * @file bsp_i2c.c
+ * @brief I2C主机驱动实现
+ *
+ * @date 2026-02-07
+ */
+#include "STC8H.h"
+#include "bsp_i2c.h"
+#include "spsc_queue.h"
+#include "baremetal_sem.h"
+
+#if I2C_ENABLE
+
+// 传输状态机
+typedef enum {
+    I2C_ST_IDLE = 0,  // 总线空闲
+    I2C_ST_WRITE,     // 写地址或写数据已发出，等待ACK
+    I2C_ST_READ_ADDR, // 读地址已发出，等待ACK
+    I2C_ST_READ,      // 接收数据中
+    I2C_ST_STOP,      // 停止信号已发出
+} i2c_state_t;
+
+// 传输队列：任务写入请求指针，中断处理完队首后取出；队首即当前传输
+static xdata SPSC_QUEUE(i2c_xfer_t xdata *, I2C_QUEUE_SIZE) i2c_queue;
+static data volatile uint8_t i2c_state = I2C_ST_IDLE;
+static data uint8_t i2c_idx;     // 当前传输的读/写字节索引
+static data uint8_t i2c_result;  // 停止信号发出后写入请求的状态
+
+// 发出主机命令，保持主机中断使能
+#define I2C_CMD(cmd) (I2CMSCR = I2C_MSCR_EMSI | (cmd))
+
+// 开始队首的传输：发起始信号和地址；中断和任务（关中断后）都要用，
+// 写成宏而不是函数，避免C51不可重入函数被两个上下文调用
+#define I2C_START_HEAD()                                  \
+    do {                                                  \
+        i2c_xfer_t xdata *h_ = SPSC_FRONT(i2c_queue);     \
+        i2c_idx = 0;                                      \
+        if (h_->wr_len) {                                 \
+            I2CTXD = h_->addr << 1;                       \
+            i2c_state = I2C_ST_WRITE;                     \
+        } else {                                          \
+            I2CTXD = (h_->addr << 1) | 0x01;              \
+            i2c_state = I2C_ST_READ_ADDR;                 \
+        }                                                 \
+        I2C_CMD(I2C_CMD_START_TX);                        \
+    } while (0)
+
+// I2C主机初始化
+void i2c_init(void) {
+    SPSC_INIT(i2c_queue);
+    i2c_state = I2C_ST_IDLE;
+
+    P_SW2 = (P_SW2 & ~0x30) | I2C_PIN_SEL;  // I2C引脚切换，保留EAXFR位
+    I2C_PIN_INIT();                          // SCL、SDA开漏并使能内部上拉
+
+    I2CCFG = I2C_CFG_EN | I2C_CFG_MASTER | I2C_MSSPEED;
+    I2CMSST = 0x00;
+    I2CMSCR = I2C_MSCR_EMSI;  // 只使能主机中断，不发命令
+}
+
+// 提交传输请求
+bool i2c_submit(i2c_xfer_t xdata *x) {
+    bool ok = false;
+
+    if ((x->wr_len == 0 && x->rd_len == 0) || x->wr_len > I2C_XFER_MAX || x->rd_len > I2C_XFER_MAX ||
+        x->status == I2C_XFER_PENDING) {
+        return false;
+    }
+
+    x->status = I2C_XFER_PENDING;
+    SEM_ENTER();  // 与中断中"取出队首并判断是否空闲"互斥，避免请求入队后无人启动
+    if (SPSC_PUSH(i2c_queue, x)) {
+        ok = true;
+        if (i2c_state == I2C_ST_IDLE) {
+            I2C_START_HEAD();
+        }
+    }
+    SEM_EXIT();
+
+    if (!ok) {
+        x->status = I2C_XFER_IDLE;
+    }
+    return ok;
+}
+
+// 查询总线是否忙
+bool i2c_busy(void) {
+    return (i2c_state != I2C_ST_IDLE) ? true : false;
+}
+
+// I2C 中断服务函数
+void i2c_isr(void) interrupt I2C_VECTOR {
+    i2c_xfer_t xdata *x;
+
+    if (!(I2CMSST & I2C_MSST_IF)) {
+        return;
+    }
+    I2CMSST &= ~I2C_MSST_IF;
+
+    x = SPSC_FRONT(i2c_queue);
+    switch (i2c_state) {
+    case I2C_ST_WRITE:
+        if (I2CMSST & I2C_MSST_ACKI) {
+            i2c_result = I2C_XFER_NACK;
+            i2c_state = I2C_ST_STOP;
+            I2C_CMD(I2C_CMD_STOP);
+        } else if (i2c_idx < x->wr_len) {
+            I2CTXD = x->wr_buf[i2c_idx++];
+            I2C_CMD(I2C_CMD_TX);
+        } else if (x->rd_len) {
+            I2CTXD = (x->addr << 1) | 0x01;  // 重复起始，转为读
+            i2c_state = I2C_ST_READ_ADDR;
+            I2C_CMD(I2C_CMD_START_TX);
+        } else {
+            i2c_result = I2C_XFER_DONE;
+            i2c_state = I2C_ST_STOP;
+            I2C_CMD(I2C_CMD_STOP);
+        }
+        break;
+
+    case I2C_ST_READ_ADDR:
+        if (I2CMSST & I2C_MSST_ACKI) {
+            i2c_result = I2C_XFER_NACK;
+            i2c_state = I2C_ST_STOP;
+            I2C_CMD(I2C_CMD_STOP);
+        } else {
+            i2c_idx = 0;
+            i2c_state = I2C_ST_READ;
+            I2C_CMD((x->rd_len == 1) ? I2C_CMD_RX_NAK : I2C_CMD_RX_ACK);  // 最后一个字节回NAK
+        }
+        break;
+
+    case I2C_ST_READ:
+        x->rd_buf[i2c_idx++] = I2CRXD;
+        if (i2c_idx < x->rd_len) {
+            I2C_CMD((i2c_idx == x->rd_len - 1) ? I2C_CMD_RX_NAK : I2C_CMD_RX_ACK);
+        } else {
+            i2c_result = I2C_XFER_DONE;
+            i2c_state = I2C_ST_STOP;
+            I2C_CMD(I2C_CMD_STOP);
+        }
+        break;
+
+    case I2C_ST_STOP:
+        // 停止信号已发出：写回结果，取出队首，继续下一个传输
+        x->status = i2c_result;
+        SPSC_RELEASE(i2c_queue);
+        if (SPSC_EMPTY(i2c_queue)) {
+            i2c_state = I2C_ST_IDLE;
+        } else {
+            I2C_START_HEAD();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+#endif /* I2C_ENABLE */
@@ -0,0 +1,89 @@
+/**
+ * @file bsp_i2c.h
+ * @brief I2C主机驱动头文件，中断驱动的非阻塞传输队列
+ * @note 任务侧只把传输请求放入队列即返回，传输由I2C中断逐步推进：
+ *       每个中断发出下一条组合命令（起始+发地址+收ACK、发数据+收ACK、收数据+发ACK/NAK、停止），
+ *       CPU不等待总线；传输完成后由中断写入请求的状态，任务侧查询状态即可。
+ *       传输请求由调用方分配（放在xdata中），排队期间不得修改或释放。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __BSP_I2C_H__
+#define __BSP_I2C_H__
+
+#include "gl08_config.h"
+
+#if I2C_ENABLE
+
+#define I2C_XFER_MAX 8         // 单次传输的写入/读出数据最大字节数
+#define I2C_QUEUE_SIZE 4       // 传输队列容量（2的幂），可排队3个请求
+#define I2C_SPEED_HZ 400000UL  // SCL频率
+
+// I2C寄存器位定义
+#define I2C_CFG_EN 0x80        // I2CCFG：使能I2C
+#define I2C_CFG_MASTER 0x40    // I2CCFG：主机模式
+#define I2C_MSCR_EMSI 0x80     // I2CMSCR：主机中断使能
+#define I2C_MSST_BUSY 0x80     // I2CMSST：主机忙
+#define I2C_MSST_IF 0x40       // I2CMSST：主机中断标志
+#define I2C_MSST_ACKI 0x02     // I2CMSST：收到的ACK位，1为NAK
+
+// 主机命令（I2CMSCR低4位）
+#define I2C_CMD_STOP 0x06          // 发送停止信号
+#define I2C_CMD_START_TX 0x09      // 起始信号 + 发送I2CTXD + 接收ACK
+#define I2C_CMD_TX 0x0A            // 发送I2CTXD + 接收ACK
+#define I2C_CMD_RX_ACK 0x0B        // 接收数据到I2CRXD + 发送ACK
+#define I2C_CMD_RX_NAK 0x0C        // 接收数据到I2CRXD + 发送NAK
+
+// SCL = FOSC / 2 / (MSSPEED × 2 + 4)
+#define I2C_MSSPEED ((FOSC / 2 / I2C_SPEED_HZ - 4) / 2)
+#if I2C_MSSPEED > 0x3F
+#error "I2C_SPEED_HZ过低，超出MSSPEED范围"
+#endif
+
+// 传输状态
+typedef enum {
+    I2C_XFER_IDLE = 0,   // 未提交或已被调用方取走结果
+    I2C_XFER_PENDING,    // 已排队或传输中
+    I2C_XFER_DONE,       // 传输成功
+    I2C_XFER_NACK,       // 地址或数据未被应答，已发送停止信号
+} i2c_xfer_status_t;
+
+// 传输请求：先写wr_len字节，再以重复起始读rd_len字节；任一长度可为0（不能同时为0）
+typedef struct {
+    uint8_t addr;                   // 7位从机地址
+    uint8_t wr_len;                 // 写入字节数
+    uint8_t rd_len;                 // 读出字节数
+    volatile uint8_t status;        // 传输状态，i2c_xfer_status_t，中断写入
+    uint8_t wr_buf[I2C_XFER_MAX];   // 写入数据
+    uint8_t rd_buf[I2C_XFER_MAX];   // 读出数据，DONE后有效
+} i2c_xfer_t;
+
+/**
+ * @brief I2C主机初始化：引脚切换到I2C_PIN_SEL，开漏带上拉，使能主机中断
+ */
+void i2c_init(void);
+
+/**
+ * @brief 提交传输请求，放入队列后立即返回
+ * @note 仅在任务上下文调用；总线空闲时立即发出起始信号，否则在前一个传输结束后由中断接着发出
+ *
+ * @param x 传输请求，需已填写地址、长度和写入数据
+ * @return true 已排队，status置为I2C_XFER_PENDING；false 队列满、请求正在排队或参数无效
+ */
+bool i2c_submit(i2c_xfer_t xdata *x);
+
+/**
+ * @brief 查询总线是否有传输在进行或排队
+ *
+ * @return true 忙
+ */
+bool i2c_busy(void);
+
+/**
+ * @brief I2C中断服务函数，推进传输状态机
+ */
+void i2c_isr(void);
+
+#endif /* I2C_ENABLE */
+
+#endif /* __BSP_I2C_H__ */
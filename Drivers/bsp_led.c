@@ -6,12 +6,15 @@
 
 #include "STC8H.h"
 #include "bsp_led.h"
+#include "gl08_config.h"
 
 // LED 初始化
 void led_init(void) {
-    // 设置 P1.2 为推挽输出
+#if !SPI_CASCADE_ENABLE
+    // 设置 P1.2 为推挽输出；SPI级联模式下P1.2为SS输入，保持高阻，不能推挽输出与主机冲突
 	P1M1 &= ~(1 << 2);
     P1M0 |= (1 << 2);
+#endif
 
     // 初始化为低电平（灭）
     LED_OFF();
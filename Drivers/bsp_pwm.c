@@ -6,49 +6,108 @@
  */
 #include "STC8H.h"
 #include "bsp_pwm.h"
-
-// PWM捕获数据结构体
+#include "spsc_queue.h"
+#include "baremetal_sem.h"
+#include "bsp_suart.h"
+#include "bsp_adc.h"
+
+// PWM捕获上升沿时间，仅中断使用
+static data uint16_t pwm_rise_time[MAX_PWM_CHANNEL];
+
+// 边沿活动监测，仅中断修改（事件标志除外）
+static data uint8_t pwm_edge_cnt[MAX_PWM_CHANNEL];                // 当前窗口的边沿数
+static data uint8_t pwm_edge_level[MAX_PWM_CHANNEL];              // 最后一个边沿之后的电平
+static data uint8_t pwm_act_periods;                              // 当前窗口已经过的计数周期数
+static data volatile uint8_t pwm_window_edges[MAX_PWM_CHANNEL];   // 上一窗口的边沿数
+static data volatile uint8_t pwm_act_state[MAX_PWM_CHANNEL];      // 活动状态，pwm_activity_t
+static data event_flags_t pwm_act_events = 0;                     // 活动状态变化事件
+
+// 捕获到一个边沿：计数并记录边沿方向
+#define PWM_EDGE(idx, level)              \
+    do {                                  \
+        if (pwm_edge_cnt[idx] < 0xFF) {   \
+            pwm_edge_cnt[idx]++;          \
+        }                                 \
+        pwm_edge_level[idx] = (level);    \
+    } while (0)
+
+// 捕获结果队列：中断写入高电平时间，任务侧取出，无需关捕获中断
+static xdata SPSC_QUEUE(uint16_t, PWM_CAPTURE_QUEUE_SIZE) pwm_capture_queue[MAX_PWM_CHANNEL];
+
+// PWM输出渐变通道结构体，占空比均为Q10.6定点
 typedef struct {
-    uint16_t rise_time;  // 上升沿时间
-    uint16_t fall_time;  // 下降沿时间
-    uint16_t duty;       // 占空比
-    uint8_t complete;    // 0: 捕获未完成，1: 捕获完成
-} pwm_capture_data_t;
+    uint16_t current;  // 当前输出占空比，由渐变引擎独占修改
+    uint16_t target;   // 目标占空比，由控制任务设置
+    uint16_t rate;     // 每个PWM周期(1ms)的最大步进量
+} pwm_fade_t;
 
-// PWM捕获数据存储
-static data volatile pwm_capture_data_t pwm_capture_data[MAX_PWM_CHANNEL] = {0};
+// PWM输出渐变数据，下标0对应D1(PWM7)，下标1对应D2(PWM8)
+static data volatile pwm_fade_t pwm_fade[2];
 
-// 保存 PWM 捕获中断使能状态
-static data uint8_t pwm_ie_backup;
+// 保存 PWMB 更新中断使能状态
+static data uint8_t pwmb_ie_backup;
 
-// 只关 PWM1 捕获中断（CC1、CC2）
-static void pwm1_ic_enter(void) {
-    pwm_ie_backup = PWMA_IER;
-    PWMA_IER &= ~PWM_CC12_IE;  // 只关闭 CC1 + CC2 中断
+// 只关 PWMB 更新中断（渐变引擎）
+static void pwmb_fade_enter(void) {
+    pwmb_ie_backup = PWMB_IER;
+    PWMB_IER &= ~PWMB_UIE;
 }
 
-static void pwm1_ic_exit(void) {
-    PWMA_IER = pwm_ie_backup;
+static void pwmb_fade_exit(void) {
+    PWMB_IER = pwmb_ie_backup;
 }
 
-// 只关 PWM2 捕获中断（CC3、CC4）
-static void pwm2_ic_enter(void) {
-    pwm_ie_backup = PWMA_IER;
-    PWMA_IER &= ~PWM_CC34_IE;  // 只关闭 CC3 + CC4 中断
-}
+#if ADC_PWM_TRIGGER
+/**
+ * @brief 计算输出周期内的安静点
+ * @note 一个周期内的开关沿：计数器归零时的上升沿，以及CCR7、CCR8处的下降沿。
+ *       取环形周期上相邻开关沿之间最大间隙，让一次触发的连续转换（ADC_TRIG_BURST_US）居中于间隙内，
+ *       离所有开关沿最远。三个间隙中最大的不小于周期的1/3（333us），连续转换总能放进去。
+ *
+ * @param duty7 PWM7比较值
+ * @param duty8 PWM8比较值
+ * @return 触发点计数值（0 ~ PWMB_PERIOD-1）
+ */
+static uint16_t pwm_quiet_point(uint16_t duty7, uint16_t duty8) {
+    uint16_t lo, hi;
+    uint16_t gap, best_gap, best_mid;
+
+    if (duty7 < duty8) {
+        lo = duty7;
+        hi = duty8;
+    } else {
+        lo = duty8;
+        hi = duty7;
+    }
 
-static void pwm2_ic_exit(void) {
-    PWMA_IER = pwm_ie_backup;
-}
+    // 间隙1：0 ~ lo
+    best_gap = lo;
+    best_mid = lo >> 1;
 
-// PWM 初始化
-void pwm_init(void) {
-    pwmb_oc_init();  // PWMB输出模式初始化
-    pwma_ic_init();  // PWMA输入捕获模式初始化
+    // 间隙2：lo ~ hi
+    gap = hi - lo;
+    if (gap > best_gap) {
+        best_gap = gap;
+        best_mid = lo + (gap >> 1);
+    }
+
+    // 间隙3：hi ~ 周期结束（回绕到0）
+    gap = PWMB_PERIOD - hi;
+    if (gap > best_gap) {
+        best_mid = hi + (gap >> 1);
+    }
+
+    // 连续转换从触发点开始，触发点提前半个连续转换时长（PWMB计数1us）
+    if (best_mid < (ADC_TRIG_BURST_US >> 1)) {
+        return 0;
+    }
+    best_mid -= ADC_TRIG_BURST_US >> 1;
+    return (best_mid >= PWMB_PERIOD) ? PWMB_PERIOD - 1 : best_mid;
 }
+#endif
 
 // PWM比较输出初始化
-void pwmb_oc_init(void) {
+void pwmb_oc_init(uint16_t duty7, uint16_t duty8) {
     PWMB_PSCR = PWMB_PSC;  // 24分频
 
     PWMB_PS = 0x50;  // bit7~bit4 = 0101，高级 PWM 通道 8 输出脚选择P3.4，
@@ -58,16 +117,38 @@ void pwmb_oc_init(void) {
     PWMB_CCMR3 = 0x60;  // 配置PWM7为PWM模式1
     PWMB_CCMR4 = 0x60;  // 配置PWM8为PWM模式1
 
-    PWMB_CCR7 = PWM7_DUTY;  // PWM7初始化占空比
-    PWMB_CCR8 = PWM8_DUTY;  // PWM8初始化占空比
+    if (duty7 > PWMB_PERIOD) duty7 = PWMB_PERIOD;
+    if (duty8 > PWMB_PERIOD) duty8 = PWMB_PERIOD;
+
+    PWMB_CCR7 = duty7;  // PWM7初始化占空比
+    PWMB_CCR8 = duty8;  // PWM8初始化占空比
+
+    // 渐变引擎从初始占空比开始，目标与当前一致
+    pwm_fade[0].current = duty7 << PWM_FADE_FRAC_BITS;
+    pwm_fade[0].target = pwm_fade[0].current;
+    pwm_fade[0].rate = PWM_FADE_RATE_DEFAULT;
+    pwm_fade[1].current = duty8 << PWM_FADE_FRAC_BITS;
+    pwm_fade[1].target = pwm_fade[1].current;
+    pwm_fade[1].rate = PWM_FADE_RATE_DEFAULT;
 
     PWMB_ARR = PWMB_PERIOD - 1;  // PWMB周期
 
     PWMB_CCER2 = 0x11;  // 使能PWM7、PWM8通道，高电平有效
 
-    PWMB_ENO = 0x50;  // 使能PWM7、PWM8端口输出
+#if ADC_PWM_TRIGGER
+    // PWM5作为ADC触发通道：不使能端口输出，仅产生内部OC5REF作为TRGO
+    PWMB_CCER1 = 0x00;                   // 写 CCMRx 前必须先清零 CCxE 关闭通道
+    PWMB_CCMR1 = PWMB_CCMR1_OC5_PWM2;    // 配置PWM5为PWM模式2
+    PWMB_CCR5 = pwm_quiet_point(duty7, duty8);
+    PWMB_CR2 = PWMB_CR2_MMS_OC5REF;      // OC5REF作为TRGO触发ADC
+#endif
+
+    PWMB_ENO = PWMB_ENO7P | PWMB_ENO8P;  // 使能PWM7、PWM8端口输出
     PWMB_BKR = 0x80;  // 使能主输出
 
+    PWMB_SR1 &= ~PWMB_UIF;  // 清除更新标志
+    PWMB_IER = PWMB_UIE;    // 使能更新中断，驱动渐变引擎
+
     PWMB_CR1 = 0x01;  // 使能计数器
 }
 
@@ -100,59 +181,179 @@ void pwma_ic_init(void) {
     PWMA_CCER2 |= 0x00;  // 设置捕获极性为CC3的上升沿
     PWMA_CCER2 |= 0x20;  // 设置捕获极性为CC4的下降沿
 
+    // 边沿活动监测：初始为有信号，第一个窗口结束时按边沿数判定；尚无边沿时电平取引脚电平
+    pwm_act_periods = 0;
+    pwm_edge_cnt[INPUT_PWM1] = 0;
+    pwm_edge_cnt[INPUT_PWM2] = 0;
+    pwm_edge_level[INPUT_PWM1] = READ_PWM1_INPUT() ? 1 : 0;
+    pwm_edge_level[INPUT_PWM2] = READ_PWM2_INPUT() ? 1 : 0;
+    pwm_window_edges[INPUT_PWM1] = 0;
+    pwm_window_edges[INPUT_PWM2] = 0;
+    pwm_act_state[INPUT_PWM1] = PWM_ACT_PRESENT;
+    pwm_act_state[INPUT_PWM2] = PWM_ACT_PRESENT;
+    PWMA_SR1 = (uint8_t)~PWMA_UIF;  // 写0清除更新标志
+    PWMA_IER = PWMA_UIE;    // 使能更新中断
+
     PWMA_CR1 = 0x01;  // 使能计数器
 }
 
-// 动态调节PWM占空比
+// 设置PWM目标占空比，实际输出由渐变引擎在PWMB更新中断中逼近
 void set_pwm_duty(uint8_t channel, uint16_t duty) {
+    uint8_t idx;
+
+    if (channel == D1) {
+        idx = 0;
+    } else if (channel == D2) {
+        idx = 1;
+    } else {
+        return;
+    }
+
     if (duty > PWM_FREQUENCY) {
         duty = PWM_FREQUENCY;
     }
 
-    switch (channel) {
-    case D1:
-        PWMB_CCR7 = duty;  // duty 范围 0 ~ PWMB_ARR
-        break;
+    pwmb_fade_enter();  // 16位目标值非原子写入，只关 PWMB 更新中断
+    pwm_fade[idx].target = duty << PWM_FADE_FRAC_BITS;
+    pwmb_fade_exit();
+}
+
+// 立即设置PWM占空比，当前值和目标值一起写入，下一个PWM周期直接输出，不经渐变
+void set_pwm_duty_now(uint8_t channel, uint16_t duty) {
+    uint8_t idx;
 
-    case D2:
-        PWMB_CCR8 = duty;  // duty 范围 0 ~ PWMB_ARR
-        break;
+    if (channel == D1) {
+        idx = 0;
+    } else if (channel == D2) {
+        idx = 1;
+    } else {
+        return;
+    }
 
-    default:
-        break;
+    if (duty > PWM_FREQUENCY) {
+        duty = PWM_FREQUENCY;
     }
+
+    pwmb_fade_enter();
+    pwm_fade[idx].target = duty << PWM_FADE_FRAC_BITS;
+    pwm_fade[idx].current = pwm_fade[idx].target;
+    pwmb_fade_exit();
+}
+
+// 获取PWM目标占空比
+uint16_t get_pwm_duty(uint8_t channel) {
+    uint16_t target;
+    uint8_t idx = (channel == D2) ? 1 : 0;
+
+    pwmb_fade_enter();
+    target = pwm_fade[idx].target;
+    pwmb_fade_exit();
+
+    return target >> PWM_FADE_FRAC_BITS;
+}
+
+// 获取渐变引擎当前的输出占空比
+uint16_t get_pwm_output(uint8_t channel) {
+    uint16_t current;
+    uint8_t idx = (channel == D2) ? 1 : 0;
+
+    pwmb_fade_enter();
+    current = pwm_fade[idx].current;
+    pwmb_fade_exit();
+
+    return current >> PWM_FADE_FRAC_BITS;
+}
+
+// 使能或关闭PWM端口输出
+void set_pwm_output_enable(uint8_t channel, bool enable) {
+    uint8_t mask;
+
+    if (channel == D1) {
+        mask = PWMB_ENO7P;
+    } else if (channel == D2) {
+        mask = PWMB_ENO8P;
+    } else {
+        return;
+    }
+
+    if (enable) {
+        PWMB_ENO |= mask;
+    } else {
+        PWMB_ENO &= ~mask;
+    }
+}
+
+// 设置PWM渐变速率
+void set_pwm_fade_rate(uint8_t channel, uint16_t rate) {
+    uint8_t idx;
+
+    if (channel == D1) {
+        idx = 0;
+    } else if (channel == D2) {
+        idx = 1;
+    } else {
+        return;
+    }
+
+    pwmb_fade_enter();
+    pwm_fade[idx].rate = rate;
+    pwmb_fade_exit();
 }
 
 // 动态获取输入捕获到的占空比值，捕获完成返回值，未完成返回PWM_CAPTURE_NOT_READY
 uint16_t get_pwm_ic_duty(uint8_t channel) {
     uint16_t ret = PWM_CAPTURE_NOT_READY;
+    uint16_t duty;
+    uint8_t idx;
 
     if (channel == PWM1) {
-        pwm1_ic_enter();  // 只关 PWM1 中断
-        if (pwm_capture_data[INPUT_PWM1].complete) {
-            ret = pwm_capture_data[INPUT_PWM1].duty;
-        }
-        pwm1_ic_exit();
+        idx = INPUT_PWM1;
     } else if (channel == PWM2) {
-        pwm2_ic_enter();  // 只关 PWM2 中断
-        if (pwm_capture_data[INPUT_PWM2].complete) {
-            ret = pwm_capture_data[INPUT_PWM2].duty;
-        }
-        pwm2_ic_exit();
+        idx = INPUT_PWM2;
+    } else {
+        return ret;
     }
 
+    // 取出全部捕获结果，保留最新一次
+    while (SPSC_POP(pwm_capture_queue[idx], duty)) {
+        ret = duty;
+    }
     return ret;
 }
 
-// 开始 CC1 和 CC2 双通道捕获，同时捕获P1.0引脚(PWM1)
-void pwma_ic1_start(void) {
+// 获取输入边沿活动状态
+uint8_t get_pwm_activity(uint8_t channel) {
+    if (channel == PWM1) {
+        return pwm_act_state[INPUT_PWM1];
+    } else if (channel == PWM2) {
+        return pwm_act_state[INPUT_PWM2];
+    }
+    return PWM_ACT_PRESENT;
+}
 
-    pwm1_ic_enter();                            // 只关 PWM1
-    if (pwm_capture_data[INPUT_PWM1].complete) {
-        pwm_capture_data[INPUT_PWM1].complete = 0;  // 只在捕获完成时清零标志
+// 获取上一个统计窗口内的输入边沿数
+uint8_t get_pwm_edge_count(uint8_t channel) {
+    if (channel == PWM1) {
+        return pwm_window_edges[INPUT_PWM1];
+    } else if (channel == PWM2) {
+        return pwm_window_edges[INPUT_PWM2];
     }
-    pwm1_ic_exit();
+    return 0;
+}
+
+// 读取并清除活动状态变化事件
+uint8_t pwm_take_activity_event(void) {
+    uint8_t got;
+
+    EVENT_TAKE(pwm_act_events, PWM_ACT_EVT(INPUT_PWM1) | PWM_ACT_EVT(INPUT_PWM2), got);
+    return got;
+}
+
+// 开始 CC1 和 CC2 双通道捕获，同时捕获P1.0引脚(PWM1)
+void pwma_ic1_start(void) {
+    SPSC_CLEAR(pwm_capture_queue[INPUT_PWM1]);  // 丢弃上个周期未读取的结果
 
+    // IER读改写期间中断若关闭了另一通道的捕获中断，可能被重新打开，只会多捕获一次，结果同样进入队列
     PWMA_CCER1 |= PWM_CC12_EN;  // 使能CC1,CC2输入捕获
     PWMA_IER |= PWM_CC12_IE;    // 使能捕获中断
     PWMA_CR1 |= 0x01;    // 确保计数器运行
@@ -160,12 +361,7 @@ void pwma_ic1_start(void) {
 
 // 开始 CC3 和 CC4 双通道捕获，同时捕获P1.4引脚(PWM2)
 void pwma_ic2_start(void) {
-
-    pwm2_ic_enter();                            // 只关 PWM2
-    if (pwm_capture_data[INPUT_PWM2].complete) {
-        pwm_capture_data[INPUT_PWM2].complete = 0;  // 只在捕获完成时清零标志
-    }
-    pwm2_ic_exit();
+    SPSC_CLEAR(pwm_capture_queue[INPUT_PWM2]);  // 丢弃上个周期未读取的结果
 
     PWMA_CCER2 |= PWM_CC34_EN;  // 使能CC3,CC4输入捕获
     PWMA_IER |= PWM_CC34_IE;    // 使能捕获中断
@@ -186,49 +382,171 @@ void pwma_ic2_stop(void) {
     // 注意：这里不停止计数器，因为可能其他功能还在使用
 }
 
-// PWM 输入捕获中断服务函数
+/**
+ * @brief 计算高电平时间：计数器在0~PWM_FREQUENCY-1循环，下降沿计数值小于上升沿时跨过了一次回绕
+ */
+static uint16_t pwm_high_time(uint16_t rise, uint16_t fall) {
+    return (fall >= rise) ? fall - rise : (PWM_FREQUENCY - rise) + fall;
+}
+
+/**
+ * @brief 捕获中断关闭期间捕获仍在进行，边沿只置捕获标志：每个计数周期计入边沿并清除标志，
+ *        重新启动捕获时不会误用旧标志
+ * @note 一个计数周期内最多各计一个上升沿和下降沿；两者都有时先后不明，电平取引脚电平
+ *
+ * @param idx 捕获通道索引
+ * @param sr 捕获标志（已按通道移到CC1/CC2位置）
+ * @param level 引脚当前电平
+ */
+static void pwm_edge_flags(uint8_t idx, uint8_t sr, uint8_t level) {
+    if ((sr & (PWM_CC1_FLAG | PWM_CC2_FLAG)) == (PWM_CC1_FLAG | PWM_CC2_FLAG)) {
+        PWM_EDGE(idx, level);
+        PWM_EDGE(idx, level);
+    } else if (sr & PWM_CC1_FLAG) {
+        PWM_EDGE(idx, 1);
+    } else if (sr & PWM_CC2_FLAG) {
+        PWM_EDGE(idx, 0);
+    }
+}
+
+/**
+ * @brief 窗口结束时按边沿数判定活动状态
+ *
+ * @param idx 捕获通道索引
+ */
+static void pwm_act_update(uint8_t idx) {
+    uint8_t edges = pwm_edge_cnt[idx];
+    uint8_t state;
+
+    pwm_edge_cnt[idx] = 0;
+    pwm_window_edges[idx] = edges;
+
+    if (edges >= PWM_ACT_MIN_EDGES) {
+        state = PWM_ACT_PRESENT;
+    } else if (edges == 0) {
+        state = pwm_edge_level[idx] ? PWM_ACT_STUCK_HIGH : PWM_ACT_STUCK_LOW;
+    } else {
+        return;  // 只有一个边沿：信号刚出现或刚消失，等下一窗口确认
+    }
+
+    if (state != pwm_act_state[idx]) {
+        pwm_act_state[idx] = state;
+        EVENT_SET(pwm_act_events, PWM_ACT_EVT(idx));  // 通知控制任务立即处理
+    }
+}
+
+// PWMA 中断服务函数：输入捕获和边沿活动监测
+// 状态标志只读一次，处理过的标志最后一次写0清除（写1的位不受影响），期间新置位的标志保留到下次中断
 void pwm_ic_isr(void) interrupt 26 {
+    uint8_t ier;
+    uint8_t sr;
+    uint8_t clr = 0;  // 已处理、需清除的标志
+
+    // 更新中断使能后，捕获中断关闭的通道也会进入本函数，捕获处理须检查对应的中断使能
+    ier = PWMA_IER;
+    sr = PWMA_SR1;
+
     // 捕获PWM1
-    if (PWMA_SR1 & PWM_CC1_FLAG) {  // CC1上升沿捕获
-        pwm_capture_data[INPUT_PWM1].rise_time = PWMA_CCR1;
-        PWMA_SR1 &= ~PWM_CC1_FLAG;  // 清除中断标志位
+    if ((ier & PWM_CC12_IE) && (sr & PWM_CC1_FLAG)) {  // CC1上升沿捕获
+        pwm_rise_time[INPUT_PWM1] = PWMA_CCR1;
+        PWM_EDGE(INPUT_PWM1, 1);
+        clr |= PWM_CC1_FLAG;
     }
-    if (PWMA_SR1 & PWM_CC2_FLAG) {  // CC2下降沿捕获
-        pwm_capture_data[INPUT_PWM1].fall_time = PWMA_CCR2;
-
-        // 计算高电平时间，周期不变，且PWM分频系数一样，高电平时间即为占空比
-        if (pwm_capture_data[INPUT_PWM1].fall_time >= pwm_capture_data[INPUT_PWM1].rise_time) {
-            pwm_capture_data[INPUT_PWM1].duty = pwm_capture_data[INPUT_PWM1].fall_time - pwm_capture_data[INPUT_PWM1].rise_time;
-        } else {
-            pwm_capture_data[INPUT_PWM1].duty = (0xFFFF - pwm_capture_data[INPUT_PWM1].rise_time) + pwm_capture_data[INPUT_PWM1].fall_time;
-        }
-        pwm_capture_data[INPUT_PWM1].complete = 1;
+    if ((ier & PWM_CC12_IE) && (sr & PWM_CC2_FLAG)) {  // CC2下降沿捕获
+        // 周期不变，且PWM分频系数一样，高电平时间即为占空比；队列满时丢弃（任务尚未取走上一次结果）
+        SPSC_PUSH(pwm_capture_queue[INPUT_PWM1], pwm_high_time(pwm_rise_time[INPUT_PWM1], PWMA_CCR2));
 
         // 关闭PWM1捕获中断（不停止捕获）
         PWMA_IER &= ~PWM_CC12_IE;  // 关闭 CC1 + CC2 中断
 
-        PWMA_SR1 &= ~PWM_CC2_FLAG;  // 清标志
+        PWM_EDGE(INPUT_PWM1, 0);
+        clr |= PWM_CC2_FLAG;
     }
 
     // 捕获PWM2
-    if (PWMA_SR1 & PWM_CC3_FLAG) {  // CC3上升沿捕获
-        pwm_capture_data[INPUT_PWM2].rise_time = PWMA_CCR3;
-        PWMA_SR1 &= ~PWM_CC3_FLAG;
+    if ((ier & PWM_CC34_IE) && (sr & PWM_CC3_FLAG)) {  // CC3上升沿捕获
+        pwm_rise_time[INPUT_PWM2] = PWMA_CCR3;
+        PWM_EDGE(INPUT_PWM2, 1);
+        clr |= PWM_CC3_FLAG;
+    }
+    if ((ier & PWM_CC34_IE) && (sr & PWM_CC4_FLAG)) {  // CC4下降沿捕获
+        SPSC_PUSH(pwm_capture_queue[INPUT_PWM2], pwm_high_time(pwm_rise_time[INPUT_PWM2], PWMA_CCR4));
+
+        // 关闭PWM2捕获中断（不停止捕获）
+        PWMA_IER &= ~PWM_CC34_IE;  // 关闭 CC3 + CC4 中断
+
+        PWM_EDGE(INPUT_PWM2, 0);
+        clr |= PWM_CC4_FLAG;
     }
-    if (PWMA_SR1 & PWM_CC4_FLAG) {  // CC4下降沿捕获
-        pwm_capture_data[INPUT_PWM2].fall_time = PWMA_CCR4;
 
-        // 计算高电平时间，周期不变，且PWM分频系数一样，高电平时间即为占空比
-        if (pwm_capture_data[INPUT_PWM2].fall_time >= pwm_capture_data[INPUT_PWM2].rise_time) {
-            pwm_capture_data[INPUT_PWM2].duty = pwm_capture_data[INPUT_PWM2].fall_time - pwm_capture_data[INPUT_PWM2].rise_time;
+    // 边沿活动监测：每个计数周期(1ms)一次
+    if (sr & PWMA_UIF) {
+        clr |= PWMA_UIF;
+
+        // 捕获中断关闭的通道只计边沿；上面已作为捕获处理的标志不重复计入
+        ier = PWMA_IER;
+        sr &= ~clr;
+        if (!(ier & PWM_CC12_IE) && (sr & (PWM_CC1_FLAG | PWM_CC2_FLAG))) {
+            pwm_edge_flags(INPUT_PWM1, sr, READ_PWM1_INPUT() ? 1 : 0);
+            clr |= sr & (PWM_CC1_FLAG | PWM_CC2_FLAG);
+        }
+        if (!(ier & PWM_CC34_IE) && (sr & (PWM_CC3_FLAG | PWM_CC4_FLAG))) {
+            pwm_edge_flags(INPUT_PWM2, sr >> 2, READ_PWM2_INPUT() ? 1 : 0);  // CC3/CC4标志移到CC1/CC2位置
+            clr |= sr & (PWM_CC3_FLAG | PWM_CC4_FLAG);
+        }
+
+        if (++pwm_act_periods >= PWM_ACT_WINDOW) {
+            pwm_act_periods = 0;
+            pwm_act_update(INPUT_PWM1);
+            pwm_act_update(INPUT_PWM2);
+        }
+    }
+
+    PWMA_SR1 = (uint8_t)~clr;  // 写0清除，不用读改写，避免清掉读取之后置位的标志
+}
+
+// 渐变单步：当前值按速率向目标值逼近，返回新的输出占空比
+static uint16_t pwm_fade_step(volatile pwm_fade_t *f) {
+    uint16_t cur = f->current;
+    uint16_t tgt = f->target;
+    uint16_t rate = f->rate;
+
+    if (cur < tgt) {
+        if (rate == PWM_FADE_RATE_INSTANT || tgt - cur <= rate) {
+            cur = tgt;
         } else {
-            pwm_capture_data[INPUT_PWM2].duty = (0xFFFF - pwm_capture_data[INPUT_PWM2].rise_time) + pwm_capture_data[INPUT_PWM2].fall_time;
+            cur += rate;
         }
-        pwm_capture_data[INPUT_PWM2].complete = 1;
+    } else if (cur > tgt) {
+        if (rate == PWM_FADE_RATE_INSTANT || cur - tgt <= rate) {
+            cur = tgt;
+        } else {
+            cur -= rate;
+        }
+    }
+    f->current = cur;
 
-        // 关闭PWM2捕获中断（不停止捕获）
-        PWMA_IER &= ~PWM_CC34_IE;  // 关闭 CC3 + CC4 中断
+    return cur >> PWM_FADE_FRAC_BITS;
+}
 
-        PWMA_SR1 &= ~PWM_CC4_FLAG;
+// PWMB 更新中断服务函数，每个PWM周期(1ms)在计数器溢出后更新一次比较值，与控制任务周期无关；
+// 软件串口使能时同时处理CC6比较中断
+void pwmb_update_isr(void) interrupt 27 {
+#if SUART_ENABLE
+    if (PWMB_SR1 & PWMB_CC6IF) {
+        PWMB_SR1 = (uint8_t)~PWMB_CC6IF;  // 写0清除，其余位写1不受影响
+        suart_tick();  // 先于渐变引擎处理，减小采样点抖动
+    }
+#endif
+    if (PWMB_SR1 & PWMB_UIF) {
+        uint16_t duty7 = pwm_fade_step(&pwm_fade[0]);
+        uint16_t duty8 = pwm_fade_step(&pwm_fade[1]);
+
+        PWMB_CCR7 = duty7;  // 更新事件后立即写入，本周期生效
+        PWMB_CCR8 = duty8;
+#if ADC_PWM_TRIGGER
+        PWMB_CCR5 = pwm_quiet_point(duty7, duty8);  // ADC触发点跟随输出开关沿移动
+#endif
+        PWMB_SR1 = (uint8_t)~PWMB_UIF;  // 清除中断标志位；不用读改写，避免清掉期间置位的CC6标志
     }
 }
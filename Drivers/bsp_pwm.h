@@ -9,6 +9,7 @@
 
 #include "STC8H.h"
 #include "type_def.h"
+#include "gl08_config.h"
 
 // PWM配置常量
 #define GL08_CH1 1        // 通道1，对应PWM1、D1
@@ -17,11 +18,17 @@
 // PWMB输出配置（用于输出PWM波）
 #define PWMB_PSC (24 - 1)       // PWMB时钟预分频系数
 #define PWMB_PERIOD 1000         // PWMB周期值，频率=FOSC/(PWMB_PSC+1)/PWMB_PERIOD=1000Hz
-#define PWM7_DUTY 500           // PWM7初始占空比，50%
-#define PWM8_DUTY 500           // PWM8初始占空比，50%
+#define PWM7_DUTY 500           // PWM7默认初始占空比，50%（无掉电保存记录时使用）
+#define PWM8_DUTY 500           // PWM8默认初始占空比，50%（无掉电保存记录时使用）
 #define D1 GL08_CH1             // PWM7，端口P3.3
 #define D2 GL08_CH2             // PWM8，端口P3.4
 
+// PWMB输出渐变引擎配置（在PWMB更新中断中运行，每个PWM周期即1ms执行一次）
+#define PWM_FADE_FRAC_BITS 6     // 渐变累加器小数位数，占空比Q10.6定点，1000<<6仍在16位范围内
+#define PWM_FADE_RATE(units_per_ms) ((uint16_t)((units_per_ms) * (1 << PWM_FADE_FRAC_BITS)))  // 速率换算
+#define PWM_FADE_RATE_DEFAULT PWM_FADE_RATE(2)  // 默认渐变速率：2占空比单位/ms，0%→100%约500ms；只作用于set_pwm_duty()
+#define PWM_FADE_RATE_INSTANT 0  // 速率为0表示不渐变，下一个PWM周期直接输出目标值
+
 // PWMA输入捕获配置（用于输入捕获外部PWM）
 #define PWMA_PSC (24 - 1)       // PWMA时钟预分频系数
 #define PWM1 GL08_CH1            // PWM1P，端口P1.0
@@ -31,6 +38,31 @@
 
 // PWM捕获未完成标志
 #define PWM_CAPTURE_NOT_READY  0xFFFF
+#define PWM_CAPTURE_QUEUE_SIZE 2   // 每通道捕获结果队列容量（2的幂）；每次启动只捕获一次，1个元素即够用
+
+// PWMB触发ADC配置（ADC_PWM_TRIGGER为1时使用）
+// PWM5不输出到引脚，仅作内部比较通道：PWM模式2下OC5REF在CNT=CCR5时产生上升沿，经TRGO触发ADC
+#define PWMB_CCMR1_OC5_PWM2 0x70  // OC5为PWM模式2
+#define PWMB_CR2_MMS_OC5REF 0x40  // 主模式选择：OC5REF作为TRGO
+
+// 输入边沿活动监测：PWMA计数器每个周期(1ms)溢出一次，更新中断按窗口统计输入边沿数
+#define PWM_ACT_WINDOW 2           // 统计窗口，单位：计数周期（ms）；1kHz输入每窗口约4个边沿
+#define PWM_ACT_MIN_EDGES 2        // 窗口内至少有一个上升沿和一个下降沿才判为有信号
+#define PWM_ACT_EVT(idx) (1 << (idx))  // 活动状态变化事件位，idx为pwm_capture_channel_t
+
+// PWMA更新中断位掩码
+#define PWMA_UIE      0x01   // 更新中断使能位
+#define PWMA_UIF      0x01   // 更新中断标志位
+
+// PWMB端口输出使能位（PWMB_ENO）
+#define PWMB_ENO7P    0x10   // PWM7(D1)端口输出使能
+#define PWMB_ENO8P    0x40   // PWM8(D2)端口输出使能
+
+// PWMB更新中断位掩码
+#define PWMB_UIE      0x01   // 更新中断使能位
+#define PWMB_UIF      0x01   // 更新中断标志位
+#define PWMB_CC6IE    0x04   // CC6比较中断使能位（软件串口位定时）
+#define PWMB_CC6IF    0x04   // CC6比较中断标志位
 
 // PWM捕获中断使能位掩码
 #define PWM_CC1_IE    0x02   // CC1中断使能位
@@ -63,15 +95,21 @@ typedef enum {
     MAX_PWM_CHANNEL
 } pwm_capture_channel_t;
 
-/**
- * @brief 初始化PWM模块
- */
-void pwm_init(void);
+// 输入边沿活动状态
+typedef enum {
+    PWM_ACT_PRESENT = 0,  // 有信号：窗口内边沿数不少于PWM_ACT_MIN_EDGES
+    PWM_ACT_STUCK_LOW,    // 窗口内无边沿，最后一个边沿是下降沿
+    PWM_ACT_STUCK_HIGH    // 窗口内无边沿，最后一个边沿是上升沿
+} pwm_activity_t;
 
 /**
- * @brief 初始化PWM输出模式
+ * @brief 初始化PWM输出模式并立即开始输出
+ * @note 上电时最先调用，按恢复的占空比输出，渐变引擎从该占空比开始
+ *
+ * @param duty7 PWM7(D1)初始占空比 (0 ~ PWM_FREQUENCY)
+ * @param duty8 PWM8(D2)初始占空比 (0 ~ PWM_FREQUENCY)
  */
-void pwmb_oc_init(void);
+void pwmb_oc_init(uint16_t duty7, uint16_t duty8);
 
 /**
  * @brief 初始化PWM输入捕获模式
@@ -79,13 +117,56 @@ void pwmb_oc_init(void);
 void pwma_ic_init(void);
 
 /**
- * @brief 设置PWM输出占空比
+ * @brief 设置PWM输出目标占空比
+ * @note 只设置渐变目标，输出比较寄存器由PWMB更新中断中的渐变引擎按设定速率逼近目标
  *
  * @param channel PWM通道 (D1或D2)
- * @param duty 占空比值 (0 ~ PWM_FREQUENCY)
+ * @param duty 目标占空比值 (0 ~ PWM_FREQUENCY)
  */
 void set_pwm_duty(uint8_t channel, uint16_t duty);
 
+/**
+ * @brief 立即设置PWM输出占空比
+ * @note 渐变当前值和目标值同时写入，下一个PWM周期直接输出，用于输入丢失时的直流回退等需要立即生效的场合
+ *
+ * @param channel PWM通道 (D1或D2)
+ * @param duty 占空比值 (0 ~ PWM_FREQUENCY)
+ */
+void set_pwm_duty_now(uint8_t channel, uint16_t duty);
+
+/**
+ * @brief 获取PWM输出目标占空比
+ *
+ * @param channel PWM通道 (D1或D2)
+ * @return 最近一次设置的目标占空比值
+ */
+uint16_t get_pwm_duty(uint8_t channel);
+
+/**
+ * @brief 获取渐变引擎当前的输出占空比（渐变过程中的实际值）
+ *
+ * @param channel PWM通道 (D1或D2)
+ * @return 当前输出占空比值 (0 ~ PWM_FREQUENCY)
+ */
+uint16_t get_pwm_output(uint8_t channel);
+
+/**
+ * @brief 使能或关闭PWM端口输出
+ * @note 关闭后引脚恢复为GPIO（初始化时已置低），渐变引擎照常运行，其当前值可供其他输出后端使用
+ *
+ * @param channel PWM通道 (D1或D2)
+ * @param enable true使能，false关闭
+ */
+void set_pwm_output_enable(uint8_t channel, bool enable);
+
+/**
+ * @brief 设置PWM输出渐变速率
+ *
+ * @param channel PWM通道 (D1或D2)
+ * @param rate 渐变速率，Q10.6定点的占空比单位/ms，用PWM_FADE_RATE()换算；PWM_FADE_RATE_INSTANT表示不渐变
+ */
+void set_pwm_fade_rate(uint8_t channel, uint16_t rate);
+
 /**
  * @brief 获取PWM输入捕获的占空比值
  *
@@ -94,6 +175,32 @@ void set_pwm_duty(uint8_t channel, uint16_t duty);
  */
 uint16_t get_pwm_ic_duty(uint8_t channel);
 
+/**
+ * @brief 获取输入边沿活动状态
+ * @note 每个PWM_ACT_WINDOW窗口结束时按边沿数判定：不少于PWM_ACT_MIN_EDGES为有信号，
+ *       0为持续电平（电平取最后一个边沿的方向），只有1个边沿时保持上一窗口的结论；
+ *       不采样瞬时电平，占空比接近0%/100%的信号不会被误判为直流
+ *
+ * @param channel PWM通道 (PWM1或PWM2)
+ * @return pwm_activity_t 活动状态
+ */
+uint8_t get_pwm_activity(uint8_t channel);
+
+/**
+ * @brief 获取上一个统计窗口内的输入边沿数
+ *
+ * @param channel PWM通道 (PWM1或PWM2)
+ * @return uint8_t 边沿数
+ */
+uint8_t get_pwm_edge_count(uint8_t channel);
+
+/**
+ * @brief 读取并清除活动状态变化事件
+ *
+ * @return uint8_t 状态发生变化的通道，按PWM_ACT_EVT(INPUT_PWMx)置位，0表示无变化
+ */
+uint8_t pwm_take_activity_event(void);
+
 /**
  * @brief 启动PWM1输入捕获 (P1.0引脚)
  */
@@ -115,8 +222,13 @@ void pwma_ic2_start(void);
 void pwma_ic2_stop(void);
 
 /**
- * @brief PWM输入捕获中断服务函数
+ * @brief PWMA中断服务函数：输入捕获和边沿活动监测（更新中断）
  */
 void pwm_ic_isr(void);
 
+/**
+ * @brief PWMB中断服务函数：更新中断运行输出渐变引擎，CC6比较中断驱动软件串口
+ */
+void pwmb_update_isr(void);
+
 #endif /* __BSP_PWM_H__ */
@@ -0,0 +1,127 @@
+/**
+ * @file bsp_spi.c
+ * @brief SPI从机级联驱动实现
+ *
+ * @date 2026-02-07
+ */
+#include "STC8H.h"
+#include "bsp_spi.h"
+#include "spsc_queue.h"
+
+#if SPI_CASCADE_ENABLE
+
+#define SPI_STAT_CLEAR (SPIF | WCOL)  // SPSTAT写1清零
+
+// 帧解析状态机
+typedef enum {
+    SPI_RX_HUNT = 0,  // 等待同步字节1
+    SPI_RX_SYNC,      // 等待同步字节2
+    SPI_RX_COUNT,     // 等待记录条数
+    SPI_RX_SKIP,      // 跳过前面槽位的记录
+    SPI_RX_RECORD,    // 接收本板记录
+} spi_rx_state_t;
+
+// 记录队列：中断直接写入队尾槽位，收满一条后提交
+static xdata SPSC_QUEUE(spi_cascade_rec_t, SPI_CASCADE_QUEUE_SIZE) spi_queue;
+static data uint8_t spi_rx_state;
+static data uint8_t spi_slot;   // 本板槽位号，任务写、中断读
+static data uint16_t spi_skip;  // 本板记录之前还需跳过的字节数
+static data uint8_t spi_idx;    // 本板记录的字节索引
+static bit spi_ss_idle;         // 检测到SS无效（高电平），下一个字节从帧头开始解析
+
+// SPI从机初始化
+void spi_cascade_init(uint8_t slot) {
+    SPSC_INIT(spi_queue);
+    spi_rx_state = SPI_RX_HUNT;
+    spi_slot = slot;
+    spi_ss_idle = 0;
+
+    P_SW1 = (P_SW1 & ~0x0C) | SPI_PIN_SEL;  // SPI引脚切换
+    SPI_PIN_INIT();                         // MISO推挽输出，其余输入
+
+    SPCTL = SPEN | CPHA;  // 从机（SS引脚有效），模式1，高位在前
+    SPSTAT = SPI_STAT_CLEAR;
+    SPDAT = 0x00;         // 第一个字节移出0，不会被下游当作同步字节
+    IE2 |= ESPI;
+}
+
+// 修改本板槽位号
+void spi_cascade_set_slot(uint8_t slot) {
+    spi_slot = slot;  // 单字节写入，中断在下一帧的记录条数字节处读取
+}
+
+// 检测SS无效（Timer1中断中调用）
+void spi_cascade_ss_poll(void) {
+    bit ea = EA;
+
+    // 关中断完成采样和置位：采样到高电平之后才开始的帧，第一个字节的中断一定看到标志
+    EA = 0;
+    if (SPI_SS) {
+        spi_ss_idle = 1;
+    }
+    EA = ea;
+}
+
+// 取出一条本板记录
+bool spi_cascade_read(spi_cascade_rec_t *rec) {
+    return SPSC_POP(spi_queue, *rec) ? true : false;
+}
+
+// SPI 中断服务函数：每收到一个字节一次，需在下一个字节收完之前返回
+void spi_isr(void) interrupt SPI_VECTOR {
+    uint8_t dat = SPDAT;  // 只读不写，该字节随下一个字节时钟原样转发给下游
+
+    SPSTAT = SPI_STAT_CLEAR;
+
+    // 两帧之间SS无效过：丢弃上一帧的解析状态（丢字节后spi_skip错位），从同步字节重新开始
+    if (spi_ss_idle) {
+        spi_ss_idle = 0;
+        spi_rx_state = SPI_RX_HUNT;
+    }
+
+    switch (spi_rx_state) {
+    case SPI_RX_HUNT:
+        if (dat == SPI_CASCADE_SYNC1) {
+            spi_rx_state = SPI_RX_SYNC;
+        }
+        break;
+
+    case SPI_RX_SYNC:
+        if (dat == SPI_CASCADE_SYNC2) {
+            spi_rx_state = SPI_RX_COUNT;
+        } else if (dat != SPI_CASCADE_SYNC1) {
+            spi_rx_state = SPI_RX_HUNT;
+        }
+        break;
+
+    case SPI_RX_COUNT:
+        if (spi_slot == 0 || dat < spi_slot) {
+            spi_rx_state = SPI_RX_HUNT;  // 本帧没有本板的记录
+            break;
+        }
+        spi_skip = (uint16_t)(spi_slot - 1) * SPI_CASCADE_REC_SIZE;
+        spi_idx = 0;
+        spi_rx_state = spi_skip ? SPI_RX_SKIP : SPI_RX_RECORD;
+        break;
+
+    case SPI_RX_SKIP:
+        if (--spi_skip == 0) {
+            spi_rx_state = SPI_RX_RECORD;
+        }
+        break;
+
+    case SPI_RX_RECORD:
+        SPSC_SLOT(spi_queue).dat[spi_idx] = dat;
+        if (++spi_idx >= SPI_CASCADE_REC_SIZE) {
+            SPSC_COMMIT(spi_queue);  // 队列满时丢弃本条，下一条覆盖同一槽位
+            spi_rx_state = SPI_RX_HUNT;
+        }
+        break;
+
+    default:
+        spi_rx_state = SPI_RX_HUNT;
+        break;
+    }
+}
+
+#endif /* SPI_CASCADE_ENABLE */
@@ -0,0 +1,70 @@
+/**
+ * @file bsp_spi.h
+ * @brief SPI从机级联驱动头文件，多块板子的SPI首尾相连，像移位寄存器一样一次传完整条链的数据帧
+ * @note 接线：主机MOSI接第1块板的MOSI，每块板的MISO接下一块板的MOSI，SCLK、SS并联。
+ *       STC8H的SPI只有一个数据寄存器，收到的字节留在SPDAT中，下一个字节时钟把它从MISO移出，
+ *       因此转发由硬件完成，每经过一块板延迟一个字节；中断只读SPDAT解析，不写SPDAT。
+ *       帧格式：[0xA5][0x5A][N] + N条记录 + N字节0x00填充，记录按槽位顺序排列，第k条属于槽位k：
+ *       [D1高4位<<4 | D2高4位][D1低8位][D2低8位][CRC8(槽位号 + 前3字节)]。
+ *       中断跳过前面槽位的记录，把本板记录写入队列，由任务校验CRC后使用。
+ *       Timer1每1ms采样一次SS，两帧之间SS无效过时下一个字节从帧头开始解析；丢字节造成的错位只影响当前帧。
+ *       中断最长路径（本板记录最后一字节提交队列）按生成代码估算约150个时钟（24MHz下约6us，含进出中断压栈），
+ *       与同为优先级3的ADC中断、关中断区叠加后留余量，SCLK不超过SPI_CASCADE_SCLK_MAX。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __BSP_SPI_H__
+#define __BSP_SPI_H__
+
+#include "gl08_config.h"
+
+#if SPI_CASCADE_ENABLE
+
+#define SPI_CASCADE_SYNC1 0xA5     // 帧同步字节1
+#define SPI_CASCADE_SYNC2 0x5A     // 帧同步字节2
+#define SPI_CASCADE_REC_SIZE 4     // 每条记录字节数
+#define SPI_CASCADE_QUEUE_SIZE 4   // 记录队列容量（2的幂），可缓存3帧
+#define SPI_CASCADE_SCLK_MAX 1000000UL  // 主机SCLK上限1MHz：每字节8us，中断约6us
+#define SPI_CASCADE_SS_IDLE_MS 2   // 两帧之间SS保持无效的最短时间，大于Timer1采样间隔1ms
+
+// 级联记录，原始字节，CRC由任务校验
+typedef struct {
+    uint8_t dat[SPI_CASCADE_REC_SIZE];
+} spi_cascade_rec_t;
+
+/**
+ * @brief SPI从机初始化：引脚切换到SPI_PIN_SEL，模式1（CPOL=0，CPHA=1），高位在前，使能SPI中断
+ *
+ * @param slot 本板槽位号（1 ~ 255），即本板记录在帧中的序号
+ */
+void spi_cascade_init(uint8_t slot);
+
+/**
+ * @brief 修改本板槽位号，从下一帧起生效
+ *
+ * @param slot 槽位号（1 ~ 255）
+ */
+void spi_cascade_set_slot(uint8_t slot);
+
+/**
+ * @brief 采样SS引脚，无效（高电平）时通知中断从帧头重新解析
+ * @note 在Timer1中断（1ms）中调用，主机两帧之间SS保持无效不少于SPI_CASCADE_SS_IDLE_MS
+ */
+void spi_cascade_ss_poll(void);
+
+/**
+ * @brief 取出一条本板记录
+ *
+ * @param rec 记录输出
+ * @return true 取到记录；false 队列为空
+ */
+bool spi_cascade_read(spi_cascade_rec_t *rec);
+
+/**
+ * @brief SPI中断服务函数，按字节解析帧并取出本板记录
+ */
+void spi_isr(void);
+
+#endif /* SPI_CASCADE_ENABLE */
+
+#endif /* __BSP_SPI_H__ */
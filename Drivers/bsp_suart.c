@@ -0,0 +1,210 @@
+/**
+ * @file bsp_suart.c
+ * @brief 软件串口实现
+ *
+ * @date 2026-02-07
+ */
+#include "STC8H.h"
+#include "bsp_suart.h"
+#include "bsp_pwm.h"
+#include "spsc_queue.h"
+#include "baremetal_sem.h"
+
+#if SUART_ENABLE
+
+#define SUART_PERIOD_Q ((uint16_t)PWMB_PERIOD << SUART_FRAC_BITS)  // PWMB周期，Q10.6
+#define SUART_FRAME_BITS 10  // 起始位 + 8位数据 + 停止位
+
+// 接收状态机
+typedef enum {
+    SUART_RX_IDLE = 0,  // 每个采样点检查起始位
+    SUART_RX_START,     // 起始位中部确认
+    SUART_RX_DATA,      // 数据位
+    SUART_RX_STOP,      // 停止位
+} suart_rx_state_t;
+
+// 发送队列任务写入、中断取出；接收队列中断写入、任务取出
+static xdata SPSC_QUEUE(uint8_t, SUART_TX_BUF_SIZE) suart_tx_queue;
+static xdata SPSC_QUEUE(uint8_t, SUART_RX_BUF_SIZE) suart_rx_queue;
+
+static data uint16_t suart_step;      // 采样间隔，Q10.6
+static data uint16_t suart_pos;       // 下一次比较位置，Q10.6
+static data uint16_t suart_tx_shift;  // 发送移位寄存器，低位先发，含起始位和停止位
+static data uint8_t suart_tx_bits;    // 当前字节剩余位数
+static data uint8_t suart_tx_tick;    // 当前位剩余采样点数
+static data uint8_t suart_rx_state;
+static data uint8_t suart_rx_shift;   // 接收移位寄存器
+static data uint8_t suart_rx_bits;    // 剩余数据位数
+static data uint8_t suart_rx_tick;    // 距下一次采样的采样点数
+static data volatile uint8_t suart_overrun;
+static data volatile uint8_t suart_frame_err;
+
+/**
+ * @brief 计算采样间隔，四舍五入
+ *
+ * @param baud 波特率
+ * @return uint16_t 采样间隔（Q10.6）
+ */
+static uint16_t suart_step_calc(uint16_t baud) {
+    uint32_t div = (uint32_t)baud * SUART_OVERSAMPLE;
+
+    return (uint16_t)((((uint32_t)SUART_TICK_HZ << SUART_FRAC_BITS) + div / 2) / div);
+}
+
+// 软件串口初始化
+void suart_init(uint16_t baud) {
+    uint16_t cnt;
+
+    if (baud < SUART_BAUD_MIN || baud > SUART_BAUD_MAX) {
+        baud = SUART_BAUD;
+    }
+
+    SPSC_INIT(suart_tx_queue);
+    SPSC_INIT(suart_rx_queue);
+    suart_tx_bits = 0;
+    suart_tx_tick = 0;
+    suart_rx_state = SUART_RX_IDLE;
+    suart_overrun = 0;
+    suart_frame_err = 0;
+    suart_step = suart_step_calc(baud);
+
+    SUART_PIN_INIT();
+    SUART_TXD = 1;  // 空闲高电平
+
+    // CC6为输出比较通道，冻结模式、不使能端口输出、无预装载，只产生比较中断
+    PWMB_CCMR2 = 0x00;
+    cnt = PWMB_CNTR + 100;  // 100us后开始第一次采样
+    if (cnt >= PWMB_PERIOD) {
+        cnt -= PWMB_PERIOD;
+    }
+    suart_pos = cnt << SUART_FRAC_BITS;
+    PWMB_CCR6 = cnt;
+    PWMB_SR1 = (uint8_t)~PWMB_CC6IF;  // 写0清除，其余位写1不受影响
+    PWMB_IER |= PWMB_CC6IE;
+}
+
+// 修改波特率
+bool suart_set_baud(uint16_t baud) {
+    uint16_t step;
+
+    if (baud < SUART_BAUD_MIN || baud > SUART_BAUD_MAX) {
+        return false;
+    }
+    step = suart_step_calc(baud);
+    SEM_ENTER();  // 16位变量，中断中读取
+    suart_step = step;
+    SEM_EXIT();
+    return true;
+}
+
+// 发送一个字节
+bool suart_putc(uint8_t dat) {
+    return SPSC_PUSH(suart_tx_queue, dat) ? true : false;
+}
+
+// 发送多个字节
+uint8_t suart_write(const uint8_t *buf, uint8_t len) {
+    uint8_t n;
+
+    for (n = 0; n < len; n++) {
+        if (!SPSC_PUSH(suart_tx_queue, buf[n])) {
+            break;
+        }
+    }
+    return n;
+}
+
+// 读取一个接收字节
+bool suart_getc(uint8_t *dat) {
+    return SPSC_POP(suart_rx_queue, *dat) ? true : false;
+}
+
+// 获取接收队列满丢弃的字节数
+uint8_t suart_get_overrun(void) {
+    return suart_overrun;
+}
+
+// 获取停止位错误的字节数
+uint8_t suart_get_frame_err(void) {
+    return suart_frame_err;
+}
+
+// 采样点处理（PWMB中断中调用）
+void suart_tick(void) {
+    uint8_t dat;
+
+    // 安排下一次比较：先算下一次位置再处理收发，间隔按Q10.6累加，取整误差不累积
+    if (suart_pos >= SUART_PERIOD_Q - suart_step) {
+        suart_pos -= SUART_PERIOD_Q - suart_step;
+    } else {
+        suart_pos += suart_step;
+    }
+    PWMB_CCR6 = suart_pos >> SUART_FRAC_BITS;
+
+    // 发送：每SUART_OVERSAMPLE个采样点输出一位
+    if (suart_tx_tick) {
+        suart_tx_tick--;
+    } else {
+        if (suart_tx_bits == 0 && SPSC_POP(suart_tx_queue, dat)) {
+            suart_tx_shift = ((uint16_t)dat << 1) | (1 << (SUART_FRAME_BITS - 1));  // 起始位0，停止位1
+            suart_tx_bits = SUART_FRAME_BITS;
+        }
+        if (suart_tx_bits) {
+            SUART_TXD = (suart_tx_shift & 0x01) ? 1 : 0;
+            suart_tx_shift >>= 1;
+            suart_tx_bits--;
+            suart_tx_tick = SUART_OVERSAMPLE - 1;
+        }
+    }
+
+    // 接收：起始沿落在上一个采样点之后，下一采样点位于起始位1/3~2/3处，
+    // 之后每SUART_OVERSAMPLE个采样点落在各位的1/3~2/3处
+    if (suart_rx_state == SUART_RX_IDLE) {
+        if (!SUART_RXD) {
+            suart_rx_state = SUART_RX_START;
+            suart_rx_tick = 1;
+        }
+        return;
+    }
+    if (--suart_rx_tick) {
+        return;
+    }
+    suart_rx_tick = SUART_OVERSAMPLE;
+
+    switch (suart_rx_state) {
+    case SUART_RX_START:
+        if (SUART_RXD) {
+            suart_rx_state = SUART_RX_IDLE;  // 低电平不足半位，视为毛刺
+        } else {
+            suart_rx_bits = 8;
+            suart_rx_state = SUART_RX_DATA;
+        }
+        break;
+
+    case SUART_RX_DATA:
+        suart_rx_shift >>= 1;
+        if (SUART_RXD) {
+            suart_rx_shift |= 0x80;
+        }
+        if (--suart_rx_bits == 0) {
+            suart_rx_state = SUART_RX_STOP;
+        }
+        break;
+
+    case SUART_RX_STOP:
+    default:
+        if (!SUART_RXD) {
+            if (suart_frame_err < 0xFF) {
+                suart_frame_err++;
+            }
+        } else if (!SPSC_PUSH(suart_rx_queue, suart_rx_shift)) {
+            if (suart_overrun < 0xFF) {
+                suart_overrun++;
+            }
+        }
+        suart_rx_state = SUART_RX_IDLE;
+        break;
+    }
+}
+
+#endif /* SUART_ENABLE */
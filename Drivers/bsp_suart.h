@@ -0,0 +1,92 @@
+/**
+ * @file bsp_suart.h
+ * @brief 软件串口头文件，定时中断驱动的非阻塞第二串口（8N1）
+ * @note STC8H1K08只有Timer0~Timer2且均已占用，位定时借用PWMB的CC6比较通道：
+ *       PWMB计数器1MHz自由循环，每次比较中断把CCR6后移一个采样间隔（波特率的1/3，Q10.6定点累加无漂移），
+ *       中断中发送一位或采样一次接收线。发送和接收各有一个SPSC环形队列，任务侧读写都不等待。
+ *       接收按3倍过采样检测起始位：空闲时每个采样点检查RXD，检测到低电平后下一采样点（起始位中部）确认，
+ *       之后每3个采样点在数据位中部采样一次，停止位为低时计为帧错误。
+ *       PWMB中断优先级为1，低于PWMA捕获和ADC，捕获中断造成的几us采样抖动远小于1/3位时间。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __BSP_SUART_H__
+#define __BSP_SUART_H__
+
+#include "gl08_config.h"
+
+#if SUART_ENABLE
+
+#define SUART_OVERSAMPLE 3       // 每位采样次数
+#define SUART_FRAC_BITS 6        // 采样间隔小数位数，间隔Q10.6定点，单位为PWMB计数（1us）
+#define SUART_TICK_HZ (FOSC / (PWMB_PSC + 1))  // PWMB计数频率
+#define SUART_BAUD_MIN 1200      // 采样间隔不超过PWMB周期的1/3
+#define SUART_BAUD_MAX 19200     // 中断频率57.6kHz，再高中断负载过大
+#define SUART_TX_BUF_SIZE 32     // 发送队列容量（2的幂），可缓存31字节
+#define SUART_RX_BUF_SIZE 16     // 接收队列容量（2的幂），可缓存15字节
+
+/**
+ * @brief 软件串口初始化：配置引脚和PWMB CC6比较中断
+ * @note 需在pwmb_oc_init之后调用
+ *
+ * @param baud 波特率（SUART_BAUD_MIN ~ SUART_BAUD_MAX），超出范围按SUART_BAUD
+ */
+void suart_init(uint16_t baud);
+
+/**
+ * @brief 修改波特率，从下一个采样间隔起生效
+ * @note 收发过程中修改会破坏正在传输的字节
+ *
+ * @param baud 波特率
+ * @return true 修改成功；false 超出范围
+ */
+bool suart_set_baud(uint16_t baud);
+
+/**
+ * @brief 发送一个字节，放入发送队列后立即返回
+ *
+ * @param dat 数据
+ * @return true 已入队；false 队列满，数据被丢弃
+ */
+bool suart_putc(uint8_t dat);
+
+/**
+ * @brief 发送多个字节，队列满时丢弃剩余部分
+ *
+ * @param buf 数据
+ * @param len 长度
+ * @return uint8_t 实际入队的字节数
+ */
+uint8_t suart_write(const uint8_t *buf, uint8_t len);
+
+/**
+ * @brief 读取一个接收字节
+ *
+ * @param dat 数据输出
+ * @return true 读到数据；false 队列为空
+ */
+bool suart_getc(uint8_t *dat);
+
+/**
+ * @brief 获取接收队列满丢弃的字节数
+ *
+ * @return uint8_t 丢弃字节数，饱和于255
+ */
+uint8_t suart_get_overrun(void);
+
+/**
+ * @brief 获取停止位错误的字节数
+ *
+ * @return uint8_t 帧错误字节数，饱和于255
+ */
+uint8_t suart_get_frame_err(void);
+
+/**
+ * @brief 采样点处理：安排下一次比较，发送一位、采样一次接收线
+ * @note 仅由PWMB中断在CC6比较标志置位时调用
+ */
+void suart_tick(void);
+
+#endif /* SUART_ENABLE */
+
+#endif /* __BSP_SUART_H__ */
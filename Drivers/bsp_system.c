@@ -6,6 +6,7 @@
  */
 #include "STC8H.h"
 #include "bsp_system.h"
+#include "gl08_config.h"
 
 // System 初始化
 void system_init(void) {
@@ -18,10 +19,28 @@ void system_init(void) {
     IPH |= PADCH;
     PADC = 1;
 
+    // Timer0: 最高优先级 (3)，时间戳溢出中断只有一条32位累加，同级中断不会读到写了一半的基准
+    IPH |= PT0H;
+    PT0 = 1;
+
+    // INT4: 最高优先级 (3)，自动波特率测量RXD下降沿时间，减小中断延迟抖动
+    IP2H |= PX4H;
+    IP2 |= PX4;
+
+#if SPI_CASCADE_ENABLE
+    // SPI: 最高优先级 (3)，级联帧每字节一次中断，需在下一个字节收完之前处理
+    IP2H |= PSPIH;
+    IP2 |= PSPI;
+#endif
+
     // PWM: 次高优先级 (2)
     IP2H |= PPWMAH;
     IP2 &= ~PPWMA;
 
+    // PWMB: 优先级1（输出渐变引擎）
+    IP2H &= ~PPWMBH;
+    IP2 |= PPWMB;
+
     // Timer: 优先级1
     IPH &= ~PT1H;
     PT1 = 1;
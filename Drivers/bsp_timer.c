@@ -7,14 +7,30 @@
 #include "STC8H.h"
 #include "bsp_timer.h"
 #include "task.h"
+#include "soft_timer.h"
+#include "bsp_spi.h"
 
 // Timer 配置
 #define TIMER1_RELOAD_H ((65536 - FOSC / 12 / 1000) >> 8)  // Timer1 1ms 定时器
 #define TIMER1_RELOAD_L ((65536 - FOSC / 12 / 1000) & 0xFF)
 
+#if TIMER_TS_TICKS_PER_US != 2
+#error "时间戳换算假定Timer0 12T计数频率为2MHz（FOSC=24MHz）"
+#endif
+
+static volatile uint32_t timer_uptime_ms = 0;  // 上电运行时间，单位：ms
+static volatile uint32_t timer_ts_base_us = 0;  // Timer0溢出累计的时间，单位：us
+
 // Timer 初始化
 void timer_init(void) {
-    TMOD = 0x00;  // Timer1 works in mode 0
+    TMOD = 0x00;  // Timer0、Timer1 works in mode 0
+
+    // Timer0 配置（时间戳）：12T模式，16位自动重载，重载值0即自由运行，每32.768ms溢出一次
+    AUXR &= ~T0x12;
+    TL0 = 0;
+    TH0 = 0;
+    ET0 = 1;  // Enable Timer0 interrupt
+    TR0 = 1;  // Start Timer0
 
     // Timer1 配置 (1ms)
     TL1 = TIMER1_RELOAD_L;
@@ -26,5 +42,50 @@ void timer_init(void) {
 // Timer1 中断服务函数
 void Timer1_ISR(void) interrupt TMR1_VECTOR {
     TF1 = 0;                        // 清除定时器1溢出中断标志
+    timer_uptime_ms++;              // 运行时间累加
     Task_Marks_Handler_Callback();  // 调用任务标记回调函数
+    soft_timer_tick();              // 推进软件定时器时间轮
+#if SPI_CASCADE_ENABLE
+    spi_cascade_ss_poll();          // 采样SS，两帧之间无效时SPI解析重新同步
+#endif
+}
+
+// Timer0 中断服务函数：累加溢出时间；最高优先级，其他中断读取时不会看到写了一半的32位基准
+void Timer0_ISR(void) interrupt TMR0_VECTOR {
+    timer_ts_base_us += TIMER_TS_OVF_US;
+}
+
+// 获取微秒时间戳；C51下不可重入，局部变量只在关中断期间使用，中断中再调用不会破坏被打断的调用
+uint32_t timer_get_us(void) {
+    uint32_t base;
+    uint8_t h;
+    uint8_t l;
+    bit ea = EA;
+
+    EA = 0;  // 计数值和溢出时间需一致读取，只关几条指令的时间
+    h = TH0;
+    l = TL0;
+    if (h != TH0) {
+        h = TH0;  // 读取期间低字节进位，重读（关中断期间只可能发生一次）
+        l = TL0;
+    }
+    base = timer_ts_base_us;
+    if (TF0 && !(h & 0x80)) {
+        base += TIMER_TS_OVF_US;  // 已溢出但中断尚未执行，计数值属于下一个溢出周期
+    }
+    base += (((uint16_t)h << 8) | l) >> 1;  // 恢复EA之前算完，之后的中断再调用本函数不会改写结果
+    EA = ea;
+
+    return base;
+}
+
+// 获取上电运行时间
+uint32_t timer_get_uptime_ms(void) {
+    uint32_t ms;
+    bit et1 = ET1;
+
+    ET1 = 0;  // 32位读取非原子操作，关Timer1中断保护；恢复原状态，调用方关着ET1时不会被打开
+    ms = timer_uptime_ms;
+    ET1 = et1;
+    return ms;
 }
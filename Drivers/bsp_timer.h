@@ -9,11 +9,40 @@
 
 #include "gl08_config.h"
 
+// 时间戳：Timer0 12T自由运行计数，溢出中断累加溢出时间
+#define TIMER_TS_TICK_HZ (FOSC / 12)                       // Timer0计数频率，2MHz
+#define TIMER_TS_TICKS_PER_US (TIMER_TS_TICK_HZ / 1000000)  // 每微秒计数值
+#define TIMER_TS_OVF_US (65536UL / TIMER_TS_TICKS_PER_US)   // 每次溢出的时间，32768us
+
+// 计算从start开始经过的微秒数，32位回绕后仍正确（间隔小于约71分钟）
+#define TIMER_US_SINCE(start) (timer_get_us() - (start))
+
 /**
- * @brief 定时器初始化函数，配置Timer1工作模式和中断
+ * @brief 定时器初始化函数，配置Timer1系统滴答和Timer0时间戳
  */
 void timer_init(void);
 
+/**
+ * @brief 获取微秒时间戳，单调递增，约71.6分钟回绕
+ * @note 内部短暂关总中断保证计数值与溢出时间一致，结果在恢复EA之前算完，任务和中断中均可调用；
+ *       Timer0中断为最高优先级，其他中断中调用时溢出基准总是完整的；分辨率1us（计数0.5us），读取约几微秒
+ *
+ * @return uint32_t 上电后经过的时间，单位：us
+ */
+uint32_t timer_get_us(void);
+
+/**
+ * @brief 获取上电运行时间
+ *
+ * @return uint32_t 运行时间，单位：ms，约49.7天回绕
+ */
+uint32_t timer_get_uptime_ms(void);
+
+/**
+ * @brief Timer0中断服务函数，累加时间戳溢出时间
+ */
+void Timer0_ISR(void);
+
 /**
  * @brief Timer1中断服务函数
  */
@@ -7,41 +7,185 @@
 #include "STC8H.h"
 #include "type_def.h"
 #include "bsp_uart.h"
+#include "bsp_timer.h"
+#include "bsp_suart.h"
 
-// 接收缓冲区与指针
-#define UART_BUF_SIZE 16
-static uint8_t uart_buf[UART_BUF_SIZE];
-static uint8_t rptr = 0;           // 接收写入指针
-static uint8_t wptr = 0;           // 接收读取指针（若需FIFO可扩展）
+// 数值和字符串打印的输出：软件串口使能且UART_PRINT_SUART=1时改由软件串口输出，队列满时丢弃，不等待
+#if SUART_ENABLE && UART_PRINT_SUART
+#define UART_PRINT_PUTC(c) ((void)suart_putc(c))
+#else
+#define UART_PRINT_PUTC(c) uart_send(c)
+#endif
+
+// 接收环形缓冲区：中断只写rx_head，任务只写rx_tail，8位下标读写为原子操作，双方均无需关中断
+#define UART_RX_MASK (UART_RX_BUF_SIZE - 1)
+static xdata uint8_t uart_rx_buf[UART_RX_BUF_SIZE];
+static volatile uint8_t rx_head = 0;  // 接收写入位置（中断写）
+static volatile uint8_t rx_tail = 0;  // 接收读取位置（任务写）
+static volatile uint8_t rx_overrun = 0;  // 缓冲满丢弃的字节数，饱和计数
+static volatile uint8_t rx_frame_err = 0; // 停止位错误的字节数，饱和计数
 static volatile uint8_t busy = 0;  // 发送忙标志
 
-// 新增：串口临界区函数（保护缓冲区读写）
-static void uart_enter_critical(void) {
-    ES = 0;  // 关闭串口中断，防止改写缓冲区
+// 波特率：Timer2 1T模式，波特率 = FOSC / 4 / div
+static xdata uint16_t uart_div = 1;  // 当前分频值
+
+// 自动波特率：INT4(P3.0/RXD)下降沿中断记录Timer0时间戳计数
+#define UART_AB_EDGES 4  // 0xA5的4个下降沿：起始位、bit1、bit3、bit6，相对起始位0、2、4、7个位时间
+#define UART_AB_TOL_MIN 2  // 间隔比例检查的最小容差（计数）：每个时间戳有1个计数的量化误差，高波特率时1/16不足1个计数
+static xdata volatile uint8_t uart_ab_state = UART_AB_IDLE;  // 自动波特率状态
+static xdata volatile uint8_t uart_ab_edges = 0;             // 已记录的下降沿数
+static xdata volatile uint16_t uart_ab_time[UART_AB_EDGES];  // 下降沿时间，Timer0计数（TIMER_TS_TICK_HZ）
+
+/**
+ * @brief 计算Timer2分频值，四舍五入
+ *
+ * @return uint16_t 分频值，波特率超出范围返回0
+ */
+static uint16_t uart_baud_div(uint32_t baud) {
+    uint32_t div;
+
+    if (baud == 0) {
+        return 0;
+    }
+    div = (FOSC + 2 * baud) / (4 * baud);
+    return (div == 0 || div > 0xFFFF) ? 0 : (uint16_t)div;
 }
 
-static void uart_exit_critical(void) {
-    ES = 1;  // 恢复串口中断
+/**
+ * @brief 设置Timer2分频值，等待当前字节发送完成后切换
+ */
+static void uart_apply_div(uint16_t div) {
+    uint16_t reload = (uint16_t)(65536UL - div);
+
+    while (busy)
+        ;               // 等待上一次发送完成
+    AUXR &= ~(1 << 4);  // Timer2 stop
+    T2L = reload & 0xFF;
+    T2H = reload >> 8;
+    AUXR |= (1 << 4);   // 使能 Timer2
+    uart_div = div;
 }
 
 // UART 初始化
 void uart_init(void) {
     // 配置串口模式：模式1，可变波特率8位数据，允许接收
     SCON = 0x50;  // 0x50 = 0101 0000，REN=1（允许接收），SM1=1（模式1）
+    PCON |= SMOD0;  // 模式设置后SCON.7切换为帧错误标志FE
 
     AUXR &= ~(1 << 4);  // Timer2 stop
     AUXR |= 0x01;       // 使用 Timer2 作为波特率发生器
     AUXR &= ~(1 << 3);  // Timer2 set As Timer
     AUXR |= (1 << 2);   // Timer2 设置为 1T 模式
-    T2L = BRT;          // 波特率发生器数，Timer2
-    T2H = BRT >> 8;
     IE2 &= ~(1 << 2);  // 禁止 Timer2 中断
-    AUXR |= (1 << 4);  // 使能 Timer2
+    uart_apply_div(uart_baud_div(BAUD));  // 装载默认波特率并启动Timer2
 
     ES = 1;  // 使能串口1中断
+
+#if UART_AUTOBAUD
+    uart_autobaud_start();
+#endif
+}
+
+// 计算波特率误差
+int16_t uart_baud_error(uint32_t baud) {
+    uint16_t div = uart_baud_div(baud);
+    int32_t actual;
+
+    if (div == 0) {
+        return UART_BAUD_ERR_INVALID;
+    }
+    actual = (int32_t)(FOSC / 4 / div);
+    return (int16_t)((actual - (int32_t)baud) * 10000 / (int32_t)baud);
+}
+
+// 设置波特率
+bool uart_set_baud(uint32_t baud) {
+    int16_t err = uart_baud_error(baud);
+
+    if (err == UART_BAUD_ERR_INVALID || err > UART_BAUD_ERR_MAX || err < -UART_BAUD_ERR_MAX) {
+        return false;
+    }
+    uart_apply_div(uart_baud_div(baud));
+    return true;
+}
+
+// 获取实际波特率
+uint32_t uart_get_baud(void) {
+    return FOSC / 4 / uart_div;
+}
+
+// 启动自动波特率测量
+void uart_autobaud_start(void) {
+    INTCLKO &= ~EX4;
+
+    uart_ab_edges = 0;
+    uart_ab_state = UART_AB_WAIT;
+    AUXINTIF &= ~INT4IF;
+    INTCLKO |= EX4;  // INT4只支持下降沿中断
+}
+
+// 处理自动波特率测量结果
+uart_ab_state_t uart_autobaud_poll(void) {
+    uint16_t d1;
+    uint16_t d2;
+    uint16_t d3;
+    uint16_t total;
+    uint16_t tol;
+    uint16_t div;
+
+    if (uart_ab_state != UART_AB_MEASURED) {
+        return (uart_ab_state_t)uart_ab_state;  // 空闲或仍在等待同步字节
+    }
+
+    // 各下降沿间隔依次为2、2、3个位时间
+    d1 = uart_ab_time[1] - uart_ab_time[0];
+    d2 = uart_ab_time[2] - uart_ab_time[1];
+    d3 = uart_ab_time[3] - uart_ab_time[2];
+    total = uart_ab_time[3] - uart_ab_time[0];
+    tol = total >> 4;  // 允许约1/16的测量抖动，高波特率时不小于量化误差
+    if (tol < UART_AB_TOL_MIN) {
+        tol = UART_AB_TOL_MIN;
+    }
+
+    // 7个位时间 = total / TIMER_TS_TICK_HZ，div = FOSC / 4 / 波特率 = total × FOSC / (28 × TIMER_TS_TICK_HZ)，四舍五入
+    div = (uint16_t)(((uint32_t)total * (FOSC / TIMER_TS_TICK_HZ) + 14) / 28);
+
+    rx_tail = rx_head;  // 丢弃测量期间按旧波特率收到的字节
+    if (d1 == 0 || (d1 > d2 ? d1 - d2 : d2 - d1) > tol ||
+        (2 * d3 > 3 * d1 ? 2 * d3 - 3 * d1 : 3 * d1 - 2 * d3) > 2 * tol ||
+        div < FOSC / 4 / UART_AUTOBAUD_MAX) {
+        // 不是0xA5的波形或超出支持的波特率，重新等待
+        REN = 1;
+        uart_autobaud_start();
+        return UART_AB_WAIT;
+    }
+
+    uart_apply_div(div);
+    REN = 1;
+    uart_ab_state = UART_AB_IDLE;
+    return UART_AB_LOCKED;
 }
 
-#if UART_PRINT
+// INT4中断服务函数：记录RXD下降沿时间
+void uart_autobaud_isr(void) interrupt INT4_VECTOR {
+    uint8_t h;
+    uint8_t l;
+
+    AUXINTIF &= ~INT4IF;
+
+    // 16位计数非原子读取：高字节前后一致才有效
+    do {
+        h = TH0;
+        l = TL0;
+    } while (h != TH0);
+
+    uart_ab_time[uart_ab_edges] = ((uint16_t)h << 8) | l;
+    if (++uart_ab_edges >= UART_AB_EDGES) {
+        INTCLKO &= ~EX4;    // 测量完成，关闭INT4
+        REN = 0;            // 同步字节剩余位按旧波特率接收无意义，暂停接收直到切换完成
+        uart_ab_state = UART_AB_MEASURED;
+    }
+}
 
 // UART 中断服务函数
 void uart_isr(void) interrupt 4 {
@@ -50,9 +194,25 @@ void uart_isr(void) interrupt 4 {
         busy = 0;  // 发送完成，释放忙标志
     }
     if (RI) {  // 接收中断（数据接收完成）
+        uint8_t dat = SBUF;
+        uint8_t next = (rx_head + 1) & UART_RX_MASK;
+
         RI = 0;
-        uart_buf[rptr++] = SBUF;  // 数据存入缓冲区
-        rptr %= UART_BUF_SIZE;    // 循环缓冲区，防止溢出
+        if (SCON & UART_SCON_FE) {
+            // 停止位错误：丢弃该字节，清除FE
+            SCON &= ~UART_SCON_FE;
+            if (rx_frame_err < 0xFF) {
+                rx_frame_err++;
+            }
+        } else if (next == rx_tail) {
+            // 缓冲满：丢弃新字节，不覆盖未读数据
+            if (rx_overrun < 0xFF) {
+                rx_overrun++;
+            }
+        } else {
+            uart_rx_buf[rx_head] = dat;
+            rx_head = next;
+        }
     }
 }
 
@@ -64,17 +224,22 @@ void uart_send(uint8_t dat) {
     SBUF = dat;  // 写入数据到发送缓冲
 }
 
+// 查询发送是否空闲
+bool uart_tx_idle(void) {
+    return busy ? false : true;
+}
+
 // 8位无符号数发送（0~255）
 void uart_uint8(uint8_t dat) {
     if (dat >= 100) {
-        uart_send(dat / 100 + '0');
+        UART_PRINT_PUTC(dat / 100 + '0');
         dat %= 100;
     }
     if (dat >= 10) {
-        uart_send(dat / 10 + '0');
+        UART_PRINT_PUTC(dat / 10 + '0');
         dat %= 10;
     }
-    uart_send(dat + '0');
+    UART_PRINT_PUTC(dat + '0');
 }
 
 // 16位无符号数发送（0~65535）
@@ -86,22 +251,37 @@ void uart_uint16(uint16_t dat) {
         uint8_t digit = dat / div;
         dat %= div;
         if (digit || started || div == 1) {
-            uart_send(digit + '0');
+            UART_PRINT_PUTC(digit + '0');
             started = 1;
         }
         div /= 10;
     } while (div);
 }
 
+// 32位无符号数发送（0~4294967295）
+void uart_uint32(uint32_t dat) {
+    uint8_t digits[10];
+    uint8_t n = 0;
+
+    do {
+        digits[n++] = dat % 10 + '0';
+        dat /= 10;
+    } while (dat);
+
+    while (n) {
+        UART_PRINT_PUTC(digits[--n]);
+    }
+}
+
 // 8位无符号数16进制发送
 void uart_hex8(uint8_t dat) {
     uint8_t nibble;
 
     nibble = (dat >> 4) & 0x0F;
-    uart_send(nibble + (nibble < 10 ? '0' : 'A' - 10));
+    UART_PRINT_PUTC(nibble + (nibble < 10 ? '0' : 'A' - 10));
 
     nibble = dat & 0x0F;
-    uart_send(nibble + (nibble < 10 ? '0' : 'A' - 10));
+    UART_PRINT_PUTC(nibble + (nibble < 10 ? '0' : 'A' - 10));
 }
 
 // 打印标签+16位数值+换行
@@ -120,36 +300,53 @@ void uart_print_u8(const uint8_t *label, uint8_t value) {
 
 // 换行符发送
 void uart_sentEnter(void) {
-    uart_send('\r');
-    uart_send('\n');
+    UART_PRINT_PUTC('\r');
+    UART_PRINT_PUTC('\n');
 }
 
 // 字符串发送（循环调用单字节发送）
 void uart_sendstr(const uint8_t *str) {
     while (*str) {
-        uart_send(*str++);
+        UART_PRINT_PUTC(*str++);
     }
 }
 
-// 查询方式：读取接收缓冲区（非中断场景可用）
+// 读取一个接收字节，缓冲区为空返回0
 uint8_t uart_recv(void) {
     uint8_t dat = 0;
-    uart_enter_critical();  // 临界区仅包裹"判断+读数据+改指针"
-    if (rptr != wptr) {
-        dat = uart_buf[wptr++];
-        wptr %= UART_BUF_SIZE;
+
+    if (rx_tail != rx_head) {
+        dat = uart_rx_buf[rx_tail];
+        rx_tail = (rx_tail + 1) & UART_RX_MASK;
     }
-    uart_exit_critical();
     return dat;
 }
 
-// 中断方式：判断缓冲区是否有数据（供上层逻辑轮询）
+// 批量读取接收字节
+uint8_t uart_read(uint8_t *buf, uint8_t len) {
+    uint8_t head = rx_head;  // 只取一次写入位置，之后到达的字节留给下次读取
+    uint8_t tail = rx_tail;
+    uint8_t n = 0;
+
+    while (n < len && tail != head) {
+        buf[n++] = uart_rx_buf[tail];
+        tail = (tail + 1) & UART_RX_MASK;
+    }
+    rx_tail = tail;  // 一次性释放已读空间
+    return n;
+}
+
+// 判断缓冲区是否有数据
 uint8_t uarthasdata(void) {
-    uint8_t ret;
-    uart_enter_critical();  // 仅关串口中断，几十纳秒
-    ret = (rptr != wptr);
-    uart_exit_critical();
-    return ret;
+    return rx_head != rx_tail;
 }
 
-#endif  // UART_PRINT
+// 获取接收溢出计数
+uint8_t uart_get_overrun(void) {
+    return rx_overrun;
+}
+
+// 获取帧错误计数
+uint8_t uart_get_frame_err(void) {
+    return rx_frame_err;
+}
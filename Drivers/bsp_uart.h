@@ -9,6 +9,21 @@
 
 #include "gl08_config.h"
 
+#define UART_RX_BUF_SIZE 64   // 接收缓冲区大小，必须为2的幂且不超过256
+#define UART_SCON_FE 0x80     // PCON.SMOD0=1时SCON.7为帧错误标志
+
+#define UART_BAUD_ERR_MAX 200          // 允许的波特率误差，单位0.01%（2%）
+#define UART_BAUD_ERR_INVALID 0x7FFF   // 波特率超出Timer2分频范围
+#define UART_AUTOBAUD_MAX 1000000UL    // 自动波特率支持的最高波特率，测得更高的按无效波形重新等待
+
+// 自动波特率状态
+typedef enum {
+    UART_AB_IDLE = 0,   // 未启用
+    UART_AB_WAIT,       // 等待同步字节
+    UART_AB_MEASURED,   // 已测得同步字节，等待任务侧处理（内部状态）
+    UART_AB_LOCKED,     // 已按测得的波特率切换（仅完成切换的那次查询返回）
+} uart_ab_state_t;
+
 // UART 初始化函数
 
 /**
@@ -16,6 +31,50 @@
  */
 void uart_init(void);
 
+/**
+ * @brief 计算波特率误差：Timer2 1T模式下波特率 = FOSC / 4 / div，div取整后的实际值与目标值之差
+ *
+ * @param baud 目标波特率
+ * @return int16_t 误差，单位0.01%；超出分频范围返回UART_BAUD_ERR_INVALID
+ */
+int16_t uart_baud_error(uint32_t baud);
+
+/**
+ * @brief 设置波特率，等待当前字节发送完成后切换
+ *
+ * @param baud 目标波特率
+ * @return true 已切换；false 误差超过UART_BAUD_ERR_MAX，保持原波特率
+ */
+bool uart_set_baud(uint32_t baud);
+
+/**
+ * @brief 获取当前实际波特率
+ *
+ * @return uint32_t 实际波特率 = FOSC / 4 / div
+ */
+uint32_t uart_get_baud(void);
+
+/**
+ * @brief 启动自动波特率测量：在RXD(P3.0/INT4)上测量同步字节0xA5的下降沿间隔
+ * @note 使用Timer0时间戳计数（0.5us）测量；上位机应单独发送一个0xA5，间隔2ms以上再发送数据，
+ *       测量期间按旧波特率收到的字节被丢弃；最高支持UART_AUTOBAUD_MAX（7个位时间14个计数，
+ *       分频值每差1对应约2.3个计数，总时间误差±1个计数内都取到正确的分频值）
+ */
+void uart_autobaud_start(void);
+
+/**
+ * @brief 处理自动波特率测量结果，需在任务中周期调用
+ * @note 波形不符合0xA5时自动重新等待；锁定后回到空闲，波特率保持到再次启动测量或调用uart_set_baud
+ *
+ * @return uart_ab_state_t 当前状态，UART_AB_LOCKED表示本次调用完成了切换
+ */
+uart_ab_state_t uart_autobaud_poll(void);
+
+/**
+ * @brief INT4中断服务函数，记录RXD下降沿时间
+ */
+void uart_autobaud_isr(void);
+
 // UART 发送函数
 
 /**
@@ -25,6 +84,16 @@ void uart_init(void);
  */
 void uart_send(uint8_t dat);
 
+/**
+ * @brief 查询发送是否空闲（最后一个字节已移出到停止位）
+ * @note 由发送中断清除忙标志，需在EA=1时轮询
+ *
+ * @return true 无正在发送的字节
+ */
+bool uart_tx_idle(void);
+
+// 以下数值和字符串打印函数用于调试打印：SUART_ENABLE=1且UART_PRINT_SUART=1时改由软件串口输出
+
 /**
  * @brief UART发送uint8_t类型数据
  *
@@ -39,6 +108,13 @@ void uart_uint8(uint8_t dat);
  */
 void uart_uint16(uint16_t dat);
 
+/**
+ * @brief UART发送uint32_t类型数据
+ *
+ * @param dat 要发送的数据
+ */
+void uart_uint32(uint32_t dat);
+
 /**
  * @brief UART发送8位十六进制数据
  *
@@ -79,10 +155,20 @@ void uart_sendstr(const uint8_t *str);
 /**
  * @brief UART接收单个字节数据
  *
- * @return uint8_t 接收到的数据
+ * @return uint8_t 接收到的数据，缓冲区为空返回0
  */
 uint8_t uart_recv(void);
 
+/**
+ * @brief UART批量读取接收数据
+ * @note 只读取一次中断侧写入位置，读完后一次性更新读取位置，不关串口中断
+ *
+ * @param buf 数据缓冲区
+ * @param len 最多读取的字节数
+ * @return uint8_t 实际读取的字节数
+ */
+uint8_t uart_read(uint8_t *buf, uint8_t len);
+
 /**
  * @brief UART检测是否有数据可读
  *
@@ -90,4 +176,19 @@ uint8_t uart_recv(void);
  */
 uint8_t uarthasdata(void);
 
+/**
+ * @brief 获取接收缓冲区满时丢弃的字节数
+ *
+ * @return uint8_t 丢弃字节数，饱和于255
+ */
+uint8_t uart_get_overrun(void);
+
+/**
+ * @brief 获取停止位错误（帧错误）的字节数，帧错误字节不进入缓冲区
+ * @note 波特率不匹配或线路干扰时增加
+ *
+ * @return uint8_t 帧错误字节数，饱和于255
+ */
+uint8_t uart_get_frame_err(void);
+
 #endif /* __BSP_UART_H__ */
@@ -1,72 +1,145 @@
 /**
  * @file baremetal_sem.h
- * @brief 通用裸机二值信号量模块（松耦合、易移植）
- * @note 临界区函数通过注入方式绑定，支持任意MCU移植（STC8H/STM32/51/ARM）
+ * @brief 裸机信号量与事件标志模块（仅头文件，宏实现）
+ * @note 提供二值信号量、计数信号量和8位事件标志组，全部操作在调用处展开为几条指令，
+ *       无函数调用和函数指针，不影响C51的覆盖分析。临界区策略在编译期选择：
+ *       - 默认保存EA后关总中断，退出时恢复EA，可嵌套使用
+ *       - 包含本头文件前定义SEM_ENTER()/SEM_EXIT()可替换为自定义策略（如只关某个外设中断）
+ *       信号量和标志变量必须放在data区：置位、清除、释放在8051上是单条INC/ORL/ANL/MOV指令，
+ *       本身不可打断，任务和中断均可直接调用；只有"测试并修改"的操作需要临界区。
+ *       _ISR后缀的操作用于中断中，假定没有更高优先级的中断访问同一变量，省去临界区。
+ *
+ *       用法：
+ *         static data sem_count_t rx_sem = 0;
+ *         SEM_COUNT_GIVE_ISR(rx_sem);                    // 中断中释放
+ *         SEM_COUNT_TAKE(rx_sem, ok); if (ok) { ... }    // 任务中获取
+ *
+ *         static data event_flags_t evt = 0;
+ *         EVENT_SET(evt, EVT_A);                         // 中断中置位
+ *         EVENT_TAKE(evt, EVT_A | EVT_B, got);           // 任务中测试并清除
+ *
  * @date 2026-02-09
  */
 #ifndef BAREMETAL_SEM_H
 #define BAREMETAL_SEM_H
 
+#include "STC8H.h"
 #include "type_def.h"
 
-// 前向声明：避免头文件循环依赖
-typedef struct BinarySem BinarySem_t;
+// 临界区：默认保存并关闭总中断，需成对出现在同一代码块中
+#ifndef SEM_ENTER
+#define SEM_ENTER()           \
+    {                         \
+        bit sem_ea_save = EA; \
+        EA = 0
+#define SEM_EXIT()            \
+        EA = sem_ea_save;     \
+    }
+#endif
 
-/**
- * @brief 临界区函数类型定义（松耦合核心）
- * @note 注入的函数需实现：保存中断状态→关中断 / 恢复中断状态
- */
-typedef void (*SemCriticalEnter_t)(void);  // 进入临界区函数类型
-typedef void (*SemCriticalExit_t)(void);   // 退出临界区函数类型
+// 类型定义
+typedef volatile uint8_t sem_binary_t;   // 二值信号量：1可用，0被占用
+typedef volatile uint8_t sem_count_t;    // 计数信号量：0~255
+typedef volatile uint8_t event_flags_t;  // 8位事件标志组，每位一个事件
 
-/**
- * @brief 二值信号量结构体（实例化时绑定临界区函数）
- */
-struct BinarySem {
-    uint8_t value;                      // 信号量值：1-可用，0-被占用
-    SemCriticalEnter_t enter_critical;  // 注入的进入临界区函数
-    SemCriticalExit_t exit_critical;    // 注入的退出临界区函数
-};
+#define SEM_COUNT_MAX 0xFF  // 计数信号量上限，释放时饱和
 
-/**
- * @brief 信号量操作返回值
- */
-typedef enum {
-    SEM_OK = 0,       // 操作成功
-    SEM_BUSY = 1,     // 信号量被占用（take失败）
-    SEM_ERROR = 0xFF  // 操作错误（未绑定临界区函数）
-} SemStatus_t;
+// 二值信号量
 
-/**
- * @brief 初始化二值信号量（绑定临界区函数）
- * @param sem 信号量实例指针
- * @param enter 注入的进入临界区函数
- * @param exit 注入的退出临界区函数
- * @param init_value 初始值（1-可用，0-被占用）
- * @return SEM_OK-成功，SEM_ERROR-参数错误
- */
-SemStatus_t sem_binary_init(BinarySem_t *sem, SemCriticalEnter_t enter, SemCriticalExit_t exit,
-                            uint8_t init_value);
+// 初始化，init为0或1
+#define SEM_BINARY_INIT(s, init) ((s) = (init) ? 1 : 0)
 
-/**
- * @brief 获取二值信号量（非阻塞）
- * @param sem 信号量实例指针
- * @return SEM_OK-获取成功，SEM_BUSY-被占用，SEM_ERROR-未初始化
- */
-SemStatus_t sem_binary_take(BinarySem_t *sem);
+// 释放：单条MOV指令，任务和中断均可调用
+#define SEM_BINARY_GIVE(s) ((s) = 1)
 
-/**
- * @brief 释放二值信号量
- * @param sem 信号量实例指针
- * @return SEM_OK-释放成功，SEM_ERROR-未初始化
- */
-SemStatus_t sem_binary_give(BinarySem_t *sem);
+// 获取（非阻塞），ok为1表示获取成功
+#define SEM_BINARY_TAKE(s, ok) \
+    do {                       \
+        SEM_ENTER();           \
+        (ok) = (s);            \
+        (s) = 0;               \
+        SEM_EXIT();            \
+    } while (0)
 
-/**
- * @brief 获取当前信号量值
- * @param sem 信号量实例指针
- * @return 1-可用，0-被占用，0xFF-未初始化
- */
-uint8_t sem_binary_get_value(BinarySem_t *sem);
+// 中断中获取
+#define SEM_BINARY_TAKE_ISR(s, ok) \
+    do {                           \
+        (ok) = (s);                \
+        (s) = 0;                   \
+    } while (0)
+
+// 计数信号量
+
+// 初始化
+#define SEM_COUNT_INIT(s, n) ((s) = (n))
+
+// 释放，计数饱和于SEM_COUNT_MAX
+#define SEM_COUNT_GIVE(s)              \
+    do {                               \
+        SEM_ENTER();                   \
+        if ((s) != SEM_COUNT_MAX) {    \
+            (s)++;                     \
+        }                              \
+        SEM_EXIT();                    \
+    } while (0)
+
+// 中断中释放
+#define SEM_COUNT_GIVE_ISR(s)          \
+    do {                               \
+        if ((s) != SEM_COUNT_MAX) {    \
+            (s)++;                     \
+        }                              \
+    } while (0)
+
+// 获取（非阻塞），ok为1表示获取成功并已减1
+#define SEM_COUNT_TAKE(s, ok) \
+    do {                      \
+        SEM_ENTER();          \
+        (ok) = ((s) != 0);    \
+        if (ok) {             \
+            (s)--;            \
+        }                     \
+        SEM_EXIT();           \
+    } while (0)
+
+// 中断中获取
+#define SEM_COUNT_TAKE_ISR(s, ok) \
+    do {                          \
+        (ok) = ((s) != 0);        \
+        if (ok) {                 \
+            (s)--;                \
+        }                         \
+    } while (0)
+
+// 读取当前计数（快照）
+#define SEM_COUNT_GET(s) (s)
+
+// 事件标志组
+
+// 初始化
+#define EVENT_INIT(f) ((f) = 0)
+
+// 置位/清除：单条ORL/ANL指令，任务和中断均可调用
+#define EVENT_SET(f, mask) ((f) |= (mask))
+#define EVENT_CLEAR(f, mask) ((f) &= (uint8_t)~(mask))
+
+// 测试：返回mask中已置位的标志，不清除
+#define EVENT_TEST(f, mask) ((f) & (mask))
+
+// 测试并清除：got返回mask中已置位的标志，并清除这些标志
+#define EVENT_TAKE(f, mask, got)    \
+    do {                            \
+        SEM_ENTER();                \
+        (got) = (f) & (mask);       \
+        (f) &= (uint8_t)~(got);     \
+        SEM_EXIT();                 \
+    } while (0)
+
+// 中断中测试并清除
+#define EVENT_TAKE_ISR(f, mask, got) \
+    do {                             \
+        (got) = (f) & (mask);        \
+        (f) &= (uint8_t)~(got);      \
+    } while (0)
 
 #endif  // BAREMETAL_SEM_H
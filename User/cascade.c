@@ -0,0 +1,73 @@
+/**
+ * @file cascade.c
+ * @brief SPI级联接收实现
+ *
+ * @date 2026-02-07
+ */
+#include "cascade.h"
+#include "bsp_spi.h"
+#include "bsp_pwm.h"
+#include "crc8.h"
+#include "gl08_control.h"
+#include "gl08_param.h"
+
+#if SPI_CASCADE_ENABLE
+
+static data uint16_t cascade_duty[MAX_CHANNEL];  // 最近一条合法记录的控制值
+static data uint8_t cascade_fresh;               // 尚未读取的新值，按通道位
+static data uint8_t cascade_errors;              // 校验失败次数
+
+// 级联接收初始化
+void cascade_init(void) {
+    cascade_duty[GL08_CHANNEL1] = 0;
+    cascade_duty[GL08_CHANNEL2] = 0;
+    cascade_fresh = 0;
+    cascade_errors = 0;
+    spi_cascade_init((uint8_t)param_get(PARAM_CASCADE_SLOT));
+}
+
+/**
+ * @brief 取出队列中的全部记录，校验后更新控制值
+ */
+static void cascade_poll(void) {
+    spi_cascade_rec_t rec;
+    uint8_t crc;
+    uint8_t i;
+    uint16_t d1, d2;
+
+    while (spi_cascade_read(&rec)) {
+        crc = crc8_update(0, (uint8_t)param_get(PARAM_CASCADE_SLOT));
+        for (i = 0; i < SPI_CASCADE_REC_SIZE - 1; i++) {
+            crc = crc8_update(crc, rec.dat[i]);
+        }
+        d1 = ((uint16_t)(rec.dat[0] >> 4) << 8) | rec.dat[1];
+        d2 = ((uint16_t)(rec.dat[0] & 0x0F) << 8) | rec.dat[2];
+
+        if (crc != rec.dat[SPI_CASCADE_REC_SIZE - 1] || d1 > PWM_FREQUENCY || d2 > PWM_FREQUENCY) {
+            if (cascade_errors < 0xFF) {
+                cascade_errors++;
+            }
+            continue;
+        }
+        cascade_duty[GL08_CHANNEL1] = d1;
+        cascade_duty[GL08_CHANNEL2] = d2;
+        cascade_fresh = (1 << GL08_CHANNEL1) | (1 << GL08_CHANNEL2);
+    }
+}
+
+// 获取通道的级联控制值
+uint16_t cascade_get_duty(uint8_t ch) {
+    cascade_poll();
+    if (ch >= MAX_CHANNEL || !(cascade_fresh & (1 << ch))) {
+        return PWM_CAPTURE_NOT_READY;
+    }
+    cascade_fresh &= ~(1 << ch);
+    return cascade_duty[ch];
+}
+
+// 获取校验失败的记录数
+uint8_t cascade_get_errors(void) {
+    return cascade_errors;
+}
+
+#endif /* SPI_CASCADE_ENABLE */
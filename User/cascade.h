@@ -0,0 +1,39 @@
+/**
+ * @file cascade.h
+ * @brief SPI级联接收头文件，从级联帧中取出本板槽位的两路控制值
+ * @note 帧格式和接线见bsp_spi.h；本板槽位号为运行参数PARAM_CASCADE_SLOT。
+ *       记录的CRC包含槽位号，槽位配错或帧解析错位时记录被丢弃并计数，不会用错其他板的值。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __CASCADE_H__
+#define __CASCADE_H__
+
+#include "gl08_config.h"
+
+#if SPI_CASCADE_ENABLE
+
+/**
+ * @brief 级联接收初始化，按运行参数设置槽位并启动SPI从机
+ * @note 需在param_init之后调用
+ */
+void cascade_init(void);
+
+/**
+ * @brief 获取通道的级联控制值，每条新记录只返回一次
+ *
+ * @param ch 通道索引，0为通道1，1为通道2
+ * @return 控制值 (0 ~ PWM_FREQUENCY)；上次读取后没有新记录时返回PWM_CAPTURE_NOT_READY
+ */
+uint16_t cascade_get_duty(uint8_t ch);
+
+/**
+ * @brief 获取校验失败的记录数
+ *
+ * @return uint8_t 失败次数，饱和于255
+ */
+uint8_t cascade_get_errors(void);
+
+#endif /* SPI_CASCADE_ENABLE */
+
+#endif /* __CASCADE_H__ */
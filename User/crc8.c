@@ -0,0 +1,31 @@
+/**
+ * @file crc8.c
+ * @brief CRC-8校验模块实现
+ * @note 按位计算，不占用256字节查表空间
+ *
+ * @date 2026-02-07
+ */
+#include "crc8.h"
+
+#define CRC8_POLY 0x07  // x^8 + x^2 + x + 1
+
+// 逐字节更新CRC-8
+uint8_t crc8_update(uint8_t crc, uint8_t dat) {
+    uint8_t i;
+
+    crc ^= dat;
+    for (i = 0; i < 8; i++) {
+        crc = (crc & 0x80) ? (crc << 1) ^ CRC8_POLY : (crc << 1);
+    }
+    return crc;
+}
+
+// 计算缓冲区的CRC-8
+uint8_t crc8(const uint8_t *buf, uint8_t len) {
+    uint8_t crc = CRC8_INIT;
+
+    while (len--) {
+        crc = crc8_update(crc, *buf++);
+    }
+    return crc;
+}
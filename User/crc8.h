@@ -0,0 +1,32 @@
+/**
+ * @file crc8.h
+ * @brief CRC-8校验模块头文件（多项式0x07，初值0x00）
+ *
+ * @date 2026-02-07
+ */
+#ifndef __CRC8_H__
+#define __CRC8_H__
+
+#include "type_def.h"
+
+#define CRC8_INIT 0x00  // CRC-8初值
+
+/**
+ * @brief 逐字节更新CRC-8
+ *
+ * @param crc 当前CRC值
+ * @param dat 新字节
+ * @return uint8_t 更新后的CRC值
+ */
+uint8_t crc8_update(uint8_t crc, uint8_t dat);
+
+/**
+ * @brief 计算缓冲区的CRC-8
+ *
+ * @param buf 数据缓冲区
+ * @param len 数据长度
+ * @return uint8_t CRC值
+ */
+uint8_t crc8(const uint8_t *buf, uint8_t len);
+
+#endif /* __CRC8_H__ */
@@ -0,0 +1,235 @@
+/**
+ * @file event_log.c
+ * @brief 事件日志模块实现
+ *
+ * 扇区格式：
+ *   [0]     扇区头：magic(2)、扇区序号seq(2)、保留(4)
+ *   [8..]   事件记录，每条8字节，依次追加，type为0xFF表示空闲
+ * 4个扇区组成环形缓冲，seq最大的扇区为当前扇区，写满后擦除最旧的扇区继续写。
+ *
+ * @date 2026-02-07
+ */
+#include "event_log.h"
+#include "bsp_eeprom.h"
+#include "bsp_timer.h"
+#include "task.h"
+
+#define EVENT_MAGIC 0x4556                                     // 'E''V'
+#define EVENT_REC_SIZE sizeof(event_record_t)                  // 记录长度
+#define EVENT_HDR_SIZE 8                                       // 扇区头长度
+#define EVENT_SECTORS 4                                        // 日志占用扇区数
+#define EVENT_PER_SECTOR ((EEPROM_SECTOR_SIZE - EVENT_HDR_SIZE) / EVENT_REC_SIZE)  // 每扇区记录数
+#define EVENT_TYPE_EMPTY 0xFF                                  // 空记录
+
+#define EVENT_RAM_SLOTS 16           // RAM缓冲记录数
+#define EVENT_FLUSH_BATCH 8          // 攒够8条（64字节）写入一次
+#define EVENT_FLUSH_MS 60000UL       // 或最早一条等待60s后写入
+#define EVENT_STAT_MS 60000UL        // 调度超时统计周期60s
+#define EVENT_RATE_MS 60000UL        // 限速窗口60s
+#define EVENT_RATE_MAX 8             // 每个限速窗口最多记录8条（一批），超出的计入丢弃数
+
+static xdata event_record_t event_ram[EVENT_RAM_SLOTS];  // RAM批量缓冲
+static xdata uint8_t event_ram_cnt = 0;                        // 缓冲中的记录数
+static xdata uint8_t event_dropped = 0;                        // 缓冲满丢弃的记录数
+static xdata uint32_t event_stat_ms = 0;                       // 上次调度超时统计的上电毫秒数
+static xdata uint32_t event_rate_ms = 0;                       // 当前限速窗口开始的上电毫秒数
+static xdata uint8_t event_rate_cnt = 0;                       // 当前限速窗口内的记录数
+
+static xdata uint8_t event_sector = 0;   // 当前扇区（0~EVENT_SECTORS-1）
+static xdata uint16_t event_seq = 0;     // 当前扇区序号
+static xdata uint8_t event_slot = 0;     // 当前扇区下一个空闲记录位置
+
+// 扇区首地址
+static uint16_t event_sector_addr(uint8_t sector) {
+    return EEPROM_SECTOR_ADDR(EEPROM_SECTOR_EVENT + sector);
+}
+
+// 记录地址
+static uint16_t event_slot_addr(uint8_t sector, uint8_t slot) {
+    return event_sector_addr(sector) + EVENT_HDR_SIZE + (uint16_t)slot * EVENT_REC_SIZE;
+}
+
+/**
+ * @brief 读取扇区头
+ *
+ * @return true 扇区头有效
+ */
+static bool event_read_header(uint8_t sector, uint16_t *seq) {
+    uint8_t hdr[4];
+
+    eeprom_read(event_sector_addr(sector), hdr, sizeof(hdr));
+    if (hdr[0] != (EVENT_MAGIC >> 8) || hdr[1] != (EVENT_MAGIC & 0xFF)) {
+        return false;
+    }
+    *seq = ((uint16_t)hdr[2] << 8) | hdr[3];
+    return true;
+}
+
+// 擦除扇区并写入扇区头
+static void event_format(uint8_t sector, uint16_t seq) {
+    uint8_t hdr[4];
+
+    hdr[0] = EVENT_MAGIC >> 8;
+    hdr[1] = EVENT_MAGIC & 0xFF;
+    hdr[2] = seq >> 8;
+    hdr[3] = seq & 0xFF;
+    eeprom_erase_sector(event_sector_addr(sector));
+    eeprom_write(event_sector_addr(sector), hdr, sizeof(hdr));
+}
+
+// 判断记录位置是否为擦除态（全部字节为0xFF）
+static bool event_slot_blank(uint8_t sector, uint8_t slot) {
+    uint8_t buf[EVENT_REC_SIZE];
+    uint8_t i;
+
+    eeprom_read(event_slot_addr(sector, slot), buf, EVENT_REC_SIZE);
+    for (i = 0; i < EVENT_REC_SIZE; i++) {
+        if (buf[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 把RAM缓冲中的记录写入EEPROM
+ * @note 每条记录先写数据再写类型字节，写入中途掉电的记录类型仍为0xFF，读出后由上位机忽略
+ */
+static void event_flush(void) {
+    uint8_t i;
+    uint16_t addr;
+
+    for (i = 0; i < event_ram_cnt; i++) {
+        // 当前扇区写满：擦除下一个（最旧的）扇区
+        if (event_slot >= EVENT_PER_SECTOR) {
+            event_sector = (event_sector + 1) % EVENT_SECTORS;
+            event_seq++;
+            event_format(event_sector, event_seq);
+            event_slot = 0;
+        }
+        addr = event_slot_addr(event_sector, event_slot);
+        eeprom_write(addr + 1, (const uint8_t *)&event_ram[i] + 1, EVENT_REC_SIZE - 1);
+        eeprom_write(addr, &event_ram[i].type, 1);
+        event_slot++;
+    }
+    event_ram_cnt = 0;
+}
+
+// 初始化事件日志
+void event_log_init(bool wdt_reset) {
+    uint8_t i;
+    uint16_t seq;
+    bool found = false;
+
+    // 找到序号最大的扇区作为当前扇区，序号按16位回绕比较
+    for (i = 0; i < EVENT_SECTORS; i++) {
+        if (event_read_header(i, &seq) && (!found || (int16_t)(seq - event_seq) > 0)) {
+            event_sector = i;
+            event_seq = seq;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        // 首次使用：格式化第一个扇区
+        event_sector = 0;
+        event_seq = 0;
+        event_format(0, 0);
+    }
+
+    // 从扇区末尾向前定位最后一条已写记录之后的空闲位置；写入中途掉电的记录不是擦除态，一并跳过
+    for (event_slot = EVENT_PER_SECTOR; event_slot > 0; event_slot--) {
+        if (!event_slot_blank(event_sector, event_slot - 1)) {
+            break;
+        }
+    }
+
+    event_log(EVT_BOOT, RSTFLAG, 0);
+    if (wdt_reset) {
+        event_log(EVT_WDT_RESET, 0, 0);
+    }
+}
+
+// 记录一个事件到RAM缓冲
+void event_log(uint8_t type, uint8_t arg, uint16_t value) {
+    event_record_t xdata *r;
+    uint32_t now = timer_get_uptime_ms();
+
+    // 限速：每个窗口最多EVENT_RATE_MAX条，故障反复出现时EEPROM每分钟最多写一批
+    if (now - event_rate_ms >= EVENT_RATE_MS) {
+        event_rate_ms = now;
+        event_rate_cnt = 0;
+    }
+
+    if (event_ram_cnt >= EVENT_RAM_SLOTS || event_rate_cnt >= EVENT_RATE_MAX) {
+        if (event_dropped < 0xFF) {
+            event_dropped++;
+        }
+        return;
+    }
+    event_rate_cnt++;
+
+    r = &event_ram[event_ram_cnt++];
+    r->type = type;
+    r->arg = arg;
+    r->value = value;
+    r->uptime = now;
+}
+
+// 按时间顺序读取一条记录
+bool event_log_read(uint16_t index, event_record_t *rec) {
+    uint8_t sector;
+    uint8_t i;
+    uint8_t n;
+    uint16_t seq;
+
+    // 先写入缓冲，保证读出内容完整
+    if (event_ram_cnt) {
+        event_flush();
+    }
+
+    // 从当前扇区的下一个（最旧的）扇区开始，除当前扇区外有效扇区均已写满
+    sector = (event_sector + 1) % EVENT_SECTORS;
+    for (i = 0; i < EVENT_SECTORS; i++) {
+        if (event_read_header(sector, &seq)) {
+            n = (sector == event_sector) ? event_slot : EVENT_PER_SECTOR;
+            if (index < n) {
+                eeprom_read(event_slot_addr(sector, (uint8_t)index), (uint8_t *)rec, EVENT_REC_SIZE);
+                return true;
+            }
+            index -= n;
+        }
+        sector = (sector + 1) % EVENT_SECTORS;
+    }
+    return false;
+}
+
+// 获取缓冲满丢弃的事件数
+uint8_t event_log_get_dropped(void) {
+    return event_dropped;
+}
+
+// 事件日志任务
+void event_log_task(void) {
+    uint8_t i;
+    uint8_t n;
+    uint32_t now = timer_get_uptime_ms();
+
+    // 周期汇总调度超时次数，每个任务每周期最多一条记录；按上电毫秒数计，与任务实际运行间隔无关
+    if (now - event_stat_ms >= EVENT_STAT_MS) {
+        event_stat_ms = now;
+        for (i = 0; i < Task_Get_Count(); i++) {
+            n = Task_Take_Overrun(i);
+            if (n) {
+                event_log(EVT_TASK_OVERRUN, i, n);
+            }
+        }
+    }
+
+    // 攒够一批或等待超时后写入EEPROM
+    if (event_ram_cnt) {
+        if (event_ram_cnt >= EVENT_FLUSH_BATCH || now - event_ram[0].uptime >= EVENT_FLUSH_MS) {
+            event_flush();
+        }
+    }
+}
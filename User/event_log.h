@@ -0,0 +1,74 @@
+/**
+ * @file event_log.h
+ * @brief 事件日志模块头文件，在EEPROM扇区4~7中循环记录故障和统计事件
+ * @note event_log()只把事件写入RAM批量缓冲，耗时为几次字节拷贝，可在控制任务中直接调用；
+ *       缓冲由event_log_task攒够一批或超时后顺序追加到EEPROM，只有写满一个扇区进入下一扇区时才擦除。
+ *       日志由串口协议的读日志命令按时间顺序逐条读出。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __EVENT_LOG_H__
+#define __EVENT_LOG_H__
+
+#include "type_def.h"
+
+// 事件类型定义
+typedef enum {
+    EVT_BOOT = 0x01,             // 上电启动，arg：RSTFLAG复位标志
+    EVT_WDT_RESET = 0x02,        // 看门狗复位
+    EVT_CAPTURE_TIMEOUT = 0x10,  // PWM捕获超时，arg：通道
+    EVT_DC_FALLBACK = 0x11,      // 直流电平回退，arg：通道，value：回退输出值
+    EVT_BAND_NONE = 0x12,        // 波段旋钮处于无效档位，arg：通道，value：ADC码
+    EVT_TASK_OVERRUN = 0x20,     // 调度超时统计，arg：任务索引，value：统计周期内超时次数
+} event_type_t;
+
+// 事件记录（8字节，EEPROM中按此格式存放）
+typedef struct {
+    uint8_t type;       // 事件类型，0xFF表示空记录；写入EEPROM时最后写此字节作为提交标志
+    uint8_t arg;        // 事件参数
+    uint16_t value;     // 事件数据
+    uint32_t uptime;    // 上电运行时间，单位：ms
+} event_record_t;
+
+/**
+ * @brief 初始化事件日志：扫描EEPROM定位写入位置，记录启动事件
+ * @note 需在EAXSFR之后调用（读取RSTFLAG）
+ *
+ * @param wdt_reset 本次启动是否为看门狗复位（system_init清除标志前读取）
+ */
+void event_log_init(bool wdt_reset);
+
+/**
+ * @brief 记录一个事件到RAM缓冲
+ * @note 仅在任务上下文调用；缓冲满或超过每分钟的限速条数时丢弃最新事件并计数
+ *
+ * @param type 事件类型
+ * @param arg 事件参数
+ * @param value 事件数据
+ */
+void event_log(uint8_t type, uint8_t arg, uint16_t value);
+
+/**
+ * @brief 按时间顺序读取一条记录，读取前先把RAM缓冲写入EEPROM
+ * @note 写入中途掉电的记录type为0xFF，调用方应忽略
+ *
+ * @param index 记录序号，0为最旧的一条
+ * @param rec 输出：记录内容
+ * @return true 读取成功；false 序号超出已有记录数
+ */
+bool event_log_read(uint16_t index, event_record_t *rec);
+
+/**
+ * @brief 获取RAM缓冲满或超过限速时丢弃的事件数
+ *
+ * @return uint8_t 丢弃数，饱和于255
+ */
+uint8_t event_log_get_dropped(void);
+
+/**
+ * @brief 事件日志任务：汇总调度超时统计、批量写入EEPROM
+ * @note 建议10ms周期调用
+ */
+void event_log_task(void);
+
+#endif /* __EVENT_LOG_H__ */
@@ -8,80 +8,259 @@
 #pragma NOAREGS
 
 #include "filter.h"
-#include <math.h>  // 使用C99标准的math库提供abs函数
+
+#define FILTER_Q_MAX ((uint16_t)FILTER_SAMPLE_MAX << FILTER_FRAC_BITS)  // Q10.6上限
+#define FILTER_Q_HALF (1U << (FILTER_FRAC_BITS - 1))                     // 四舍五入
+
+// 无符号差的绝对值
+#define FILTER_ABS_DIFF(a, b) ((a) > (b) ? (a) - (b) : (b) - (a))
 
 /**
- * @brief 滤波器初始化（仅需初始值+N，极简）
- *
- * @param en 使能位
- * @param init_val 初始值（如0）
- * @param n 滤波长度N
- * @param pFilter 滤波状态结构体
+ * @brief 移位指数平滑：avg += (sample - avg) / 2^k
  */
-void ewma_filter_init(bool en, uint16_t init_val, uint16_t n, ewma_filter_t* pFilter) {
-  if(!en || pFilter == NULL || n <= 0) return;
-  pFilter->ave = init_val;  // 第一次采样直接赋值（符合你说的初始逻辑）
-  pFilter->n = n;
-  pFilter->is_first = true;
+static uint16_t filter_ewma(filter_t *f, uint16_t sample) {
+    uint16_t s = sample << FILTER_FRAC_BITS;
+
+    // 分正负两支，避免有符号移位
+    if (s >= f->u.acc) {
+        f->u.acc += (s - f->u.acc) >> f->k;
+    } else {
+        f->u.acc -= (f->u.acc - s) >> f->k;
+    }
+
+    // 四舍五入去掉小数位
+    return (uint16_t)(f->u.acc + FILTER_Q_HALF) >> FILTER_FRAC_BITS;
 }
 
 /**
- * @brief 重置滤波器到指定值
- * 强制将滤波器的平均值同步为指定值，并重置首轮标志。
- * 常用于信号源切换时，消除旧信号的"惯性"干扰。
- *
- * @param pFilter 滤波状态结构体
- * @param reset_val 重置后的目标值（通常为当前最新的原始采样值）
+ * @brief 滑动平均：累加和减去最旧样本加上新样本，窗口满长度恒为2^k
  */
-void ewma_filter_reset(ewma_filter_t* pFilter, uint16_t reset_val) {
-    if (pFilter == NULL) return;
+static uint16_t filter_ma(filter_t *f, uint16_t sample) {
+    uint16_t xdata *buf = f->u.win.buf;
+    uint8_t idx = f->u.win.idx;
 
-    pFilter->ave = reset_val;      // 强制更新历史平均值
-    pFilter->is_first = false;     // 既然已经有了明确的重置值，就不再视作"从未采样"
+    f->u.win.sum -= buf[idx];
+    f->u.win.sum += sample;
+    buf[idx] = sample;
+    f->u.win.idx = (idx + 1) & ((1 << f->k) - 1);
+
+    return f->u.win.sum >> f->k;
 }
 
 /**
- * @brief 单次指数平滑滤波器（整合限幅+死区，多类型采样值）
- *
- * @param en 使能位
- * @param sample 样本值
- * @param die 死区阈值（偏差≤die则滤波，＞die直接用采样值）
- * @param max_err 限幅阈值（偏差＞max_err则丢弃，用旧值）
- * @param pFilter 滤波状态结构体
- * @return 本次滤波输出值
+ * @brief 中值滤波：对窗口副本插入排序后取中间值
+ */
+static uint16_t filter_median(filter_t *f, uint16_t sample) {
+    uint16_t xdata *buf = f->u.win.buf;
+    uint16_t tmp[FILTER_MEDIAN_WIN_MAX];
+    uint16_t v;
+    uint8_t i;
+    uint8_t j;
+
+    buf[f->u.win.idx] = sample;
+    if (++f->u.win.idx >= f->k) {
+        f->u.win.idx = 0;
+    }
+
+    for (i = 0; i < f->k; i++) {
+        v = buf[i];
+        for (j = i; j > 0 && tmp[j - 1] > v; j--) {
+            tmp[j] = tmp[j - 1];
+        }
+        tmp[j] = v;
+    }
+
+    return tmp[f->k >> 1];
+}
+
+/**
+ * @brief 自适应α-β跟踪：先按速度预测，再按残差大小选择增益修正位置和速度
+ * @note 位置为Q10.6无符号数，残差按符号分两支取绝对值，全部运算在16位内完成
  */
-uint16_t ewma_filter_update(bool en, uint16_t sample, uint16_t die, uint16_t max_err,
-                        ewma_filter_t* pFilter) {
-  uint16_t err;
-  uint16_t n;
-
-  // 入参合法性检查
-  if(!en || pFilter == NULL || pFilter->n <= 0 || max_err < die) {
-    return pFilter->ave;
-  }
-
-  // 核心修复：第一次采样强制赋值，避免初始0导致限幅死循环
-  if(pFilter->is_first) {
-    pFilter->ave = sample;
-    pFilter->is_first = false;
-    return sample;
-  }
-
-  // 限幅滤波（防极端干扰）
-  err = abs((int16_t)sample - (int16_t)pFilter->ave);
-  if(err > max_err) {
-    return pFilter->ave;  // 丢弃异常值，沿用旧平均值
-  }
-
-  // 死区判断（平衡平滑与响应）
-  if(err > die) {
-    // 死区外：快速响应，直接更新平均值
-    pFilter->ave = sample;
-  } else {
-    // 死区内：加权平均滤波（核心公式，仅1个变量）
-    n = pFilter->n;
-    pFilter->ave = (pFilter->ave * (n - 1) + sample) / n;
-  }
-
-  return pFilter->ave;
+static uint16_t filter_alpha_beta(filter_t *f, uint16_t sample) {
+    uint16_t s = sample << FILTER_FRAC_BITS;
+    uint16_t x0 = f->u.ab.pos;
+    uint16_t x = x0;
+    int16_t v = f->u.ab.vel;
+    uint16_t d;
+    uint16_t err;
+    uint8_t ka;
+    bool neg;
+
+    // 按速度预测位置，超出输出范围时限幅并清除速度
+    if (v < 0) {
+        if ((uint16_t)-v > x) {
+            x = 0;
+            v = 0;
+        } else {
+            x -= (uint16_t)-v;
+        }
+    } else if ((uint16_t)v > FILTER_Q_MAX - x) {
+        x = FILTER_Q_MAX;
+        v = 0;
+    } else {
+        x += (uint16_t)v;
+    }
+
+    // 预测越过样本时放弃预测并清除速度，阶跃或斜坡结束后输出不会冲过样本
+    if ((x0 < s && x > s) || (x0 > s && x < s)) {
+        x = x0;
+        v = 0;
+    }
+
+    // 残差的绝对值和符号
+    neg = (s < x) ? true : false;
+    d = neg ? x - s : s - x;
+    err = d >> FILTER_FRAC_BITS;
+
+    // 阶跃检测：残差过大时先保持，连续几次落在同一位置才认定为真实阶跃
+    if (f->max_err && err > f->max_err) {
+        if (f->u.ab.confirm && FILTER_ABS_DIFF(sample, f->u.ab.cand) <= (f->max_err >> 1)) {
+            if (++f->u.ab.confirm >= FILTER_AB_STEP_CONFIRM) {
+                filter_reset(f, sample);
+                return sample;
+            }
+        } else {
+            f->u.ab.confirm = 1;
+            f->u.ab.cand = sample;
+        }
+        return f->out;
+    }
+    f->u.ab.confirm = 0;
+
+    // 残差在死区内视为平稳，重度平滑；否则为斜坡，快速跟踪。beta取alpha^2/2附近
+    ka = (err > f->die) ? FILTER_AB_TRACK_SHIFT : f->k;
+    if (neg) {
+        x -= d >> ka;
+        v -= (int16_t)(d >> ((ka << 1) + 1));
+    } else {
+        x += d >> ka;
+        v += (int16_t)(d >> ((ka << 1) + 1));
+    }
+
+    if (v > FILTER_AB_VEL_MAX) v = FILTER_AB_VEL_MAX;
+    if (v < -FILTER_AB_VEL_MAX) v = -FILTER_AB_VEL_MAX;
+    f->u.ab.pos = x;
+    f->u.ab.vel = v;
+
+    return (uint16_t)(x + FILTER_Q_HALF) >> FILTER_FRAC_BITS;
+}
+
+// 滤波器初始化
+void filter_init(filter_t *f, filter_type_t type, uint8_t k, uint16_t die, uint16_t max_err,
+                 uint16_t xdata *buf) {
+    if (f == NULL) return;
+
+    // 参数限制在缓冲区范围内
+    if (type == FILTER_MA && (1 << k) > FILTER_MA_WIN_MAX) {
+        k = 3;
+    } else if (type == FILTER_MEDIAN && k != 3) {
+        k = 5;
+    }
+
+    f->type = type;
+    f->k = k;
+    f->die = die;
+    f->max_err = max_err;
+    f->ready = 0;  // 首次采样时以样本值填充
+    f->out = 0;
+    if (type == FILTER_MA || type == FILTER_MEDIAN) {
+        f->u.win.buf = buf;
+    }
+}
+
+// 重置滤波器到指定值
+void filter_reset(filter_t *f, uint16_t value) {
+    uint8_t i;
+    uint8_t n;
+
+    if (f == NULL) return;
+
+    if (value > FILTER_SAMPLE_MAX) {
+        value = FILTER_SAMPLE_MAX;
+    }
+    f->ready = 1;
+    f->out = value;
+
+    switch (f->type) {
+    case FILTER_MA:
+    case FILTER_MEDIAN:
+        // 缓冲全部填充为重置值，无需等窗口填满
+        n = (f->type == FILTER_MA) ? (uint8_t)(1 << f->k) : f->k;
+        for (i = 0; i < n; i++) {
+            f->u.win.buf[i] = value;
+        }
+        f->u.win.sum = value << f->k;  // MEDIAN不使用
+        f->u.win.idx = 0;
+        break;
+
+    case FILTER_ALPHA_BETA:
+        f->u.ab.pos = value << FILTER_FRAC_BITS;
+        f->u.ab.vel = 0;
+        f->u.ab.confirm = 0;
+        break;
+
+    case FILTER_EWMA:
+    default:
+        f->u.acc = value << FILTER_FRAC_BITS;
+        break;
+    }
+}
+
+// 滤波器更新
+uint16_t filter_update(filter_t *f, uint16_t sample) {
+    uint16_t err;
+
+    if (f == NULL) return sample;
+
+    if (sample > FILTER_SAMPLE_MAX) {
+        sample = FILTER_SAMPLE_MAX;
+    }
+
+    // 首次采样直接赋值，避免初始值导致限幅死锁
+    if (!f->ready) {
+        filter_reset(f, sample);
+        return sample;
+    }
+
+    // α-β跟踪自带阶跃检测，不经过公共门限
+    if (f->type == FILTER_ALPHA_BETA) {
+        f->out = filter_alpha_beta(f, sample);
+        return f->out;
+    }
+
+    err = FILTER_ABS_DIFF(sample, f->out);
+
+    // 限幅：丢弃异常值，沿用上次输出
+    if (f->max_err && err > f->max_err) {
+        return f->out;
+    }
+
+    // 死区外：快速响应，直接跟随样本
+    if (f->die && err > f->die) {
+        filter_reset(f, sample);
+        return sample;
+    }
+
+    switch (f->type) {
+    case FILTER_MA:
+        f->out = filter_ma(f, sample);
+        break;
+
+    case FILTER_MEDIAN:
+        f->out = filter_median(f, sample);
+        break;
+
+    case FILTER_EWMA:
+    default:
+        f->out = filter_ewma(f, sample);
+        break;
+    }
+
+    return f->out;
+}
+
+// 获取最近一次滤波输出
+uint16_t filter_get(const filter_t *f) {
+    return f->out;
 }
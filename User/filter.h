@@ -1,6 +1,14 @@
 /**
  * @file filter.h
  * @brief 滤波算法头文件
+ * @note 所有滤波器共用一个状态结构体和一组接口，按类型选择算法，更新过程只有16位加减、比较和移位，无除法：
+ *       - FILTER_EWMA：移位指数平滑，alpha = 1/2^k，均值保留FILTER_FRAC_BITS位小数
+ *       - FILTER_MA：滑动平均，窗口2^k，增量维护累加和
+ *       - FILTER_MEDIAN：中值滤波，窗口3或5
+ *       - FILTER_ALPHA_BETA：自适应α-β跟踪，残差≤die时按k重度平滑，否则切换到快速跟踪增益；
+ *         残差>max_err视为阶跃候选，连续FILTER_AB_STEP_CONFIRM次一致后直接跳到新值
+ *         预测越过样本时放弃该次预测并清零速度，阶跃和斜坡结束时不过冲
+ *       前三种的死区/限幅门限在算法之前执行：偏差>max_err丢弃样本，偏差>die直接跟随样本。
  *
  * @date 2026-01-09
  */
@@ -10,41 +18,86 @@
 
 #include "type_def.h"
 
-// 单次指数平滑滤波算法状态结构体
+#define FILTER_FRAC_BITS 6        // 均值/位置的小数位数，Q10.6定点放进16位
+#define FILTER_SAMPLE_MAX 1023     // 样本上限，超出按上限处理（Q10.6不溢出，MA累加和不溢出）
+#define FILTER_MA_WIN_MAX 8        // MA窗口上限2^3
+#define FILTER_MEDIAN_WIN_MAX 5    // 中值窗口上限
+
+#define FILTER_AB_TRACK_SHIFT 1   // α-β跟踪增益：alpha=1/2，beta=1/8
+#define FILTER_AB_STEP_CONFIRM 2  // α-β阶跃确认次数
+#define FILTER_AB_VEL_MAX (256 << FILTER_FRAC_BITS)  // α-β速度上限，每次更新256
+
+// 滤波类型枚举
+typedef enum {
+    FILTER_EWMA = 0,  // 移位指数平滑
+    FILTER_MA,        // 2的幂滑动平均
+    FILTER_MEDIAN,    // 3/5点中值
+    FILTER_ALPHA_BETA,  // 自适应α-β跟踪
+} filter_type_t;
+
+// 滤波器状态结构体：公共字段加按类型复用的状态，全部为16位定点，共16字节
+// MA/MEDIAN的样本缓冲由调用方提供，EWMA/ALPHA_BETA不需要缓冲，状态可放在idata中
 typedef struct {
-    uint16_t ave;      // 唯一维护的变量：滤波平均值
-    uint16_t n;        // 滤波长度N（可动态调整，无需重启）
-    bool is_first; // 新增：标记是否第一次采样
-} ewma_filter_t;
+    uint8_t type;      // 滤波类型
+    uint8_t k;         // EWMA/ALPHA_BETA：alpha=1/2^k；MA：窗口=2^k；MEDIAN：窗口长度3或5
+    uint8_t ready;     // 已有样本，0表示首次采样时以样本值填充
+    uint16_t die;      // 死区阈值：偏差>die直接跟随样本，0表示不启用
+    uint16_t max_err;  // 限幅阈值：偏差>max_err丢弃样本，0表示不启用
+    uint16_t out;      // 最近一次输出
+    union {
+        uint16_t acc;  // EWMA：Q10.6均值
+        struct {
+            uint16_t xdata *buf;  // 样本缓冲，MA为2^k个，MEDIAN为k个
+            uint16_t sum;         // MA：窗口累加和
+            uint8_t idx;          // 缓冲写入位置
+        } win;
+        struct {
+            uint16_t pos;     // Q10.6位置
+            int16_t vel;      // Q10.6速度（每次更新的变化量）
+            uint16_t cand;    // 阶跃候选值
+            uint8_t confirm;  // 阶跃确认计数
+        } ab;
+    } u;
+} filter_t;
 
 /**
- * @brief 单次指数平滑滤波算法初始化
+ * @brief 滤波器初始化
  *
- * @param en 是否启用滤波
- * @param init_val 初始值
- * @param n 滤波长度N（可动态调整，无需重启）
- * @param pFilter 滤波状态结构体指针
+ * @param f 滤波状态结构体指针
+ * @param type 滤波类型
+ * @param k 类型参数（EWMA/MA/ALPHA_BETA为移位位数，MEDIAN为窗口长度3或5）
+ * @param die 死区阈值，0表示不启用
+ * @param max_err 限幅阈值，0表示不启用
+ * @param buf 样本缓冲：MA至少2^k个、MEDIAN至少k个元素；EWMA/ALPHA_BETA传NULL
  */
-void ewma_filter_init(bool en, uint16_t init_val, uint16_t n, ewma_filter_t* pFilter);
+void filter_init(filter_t *f, filter_type_t type, uint8_t k, uint16_t die, uint16_t max_err,
+                 uint16_t xdata *buf);
 
 /**
- * @brief 重置滤波器
+ * @brief 重置滤波器到指定值
+ * @note 常用于信号源切换时，消除旧信号的"惯性"干扰
  *
- * @param pFilter 滤波状态结构体指针
- * @param reset_val 重置值
+ * @param f 滤波状态结构体指针
+ * @param value 重置值
  */
-void ewma_filter_reset(ewma_filter_t* pFilter, uint16_t reset_val);
+void filter_reset(filter_t *f, uint16_t value);
 
 /**
- * @brief 单次指数平滑滤波算法更新
+ * @brief 滤波器更新
+ * @note 首次采样直接作为输出；样本超过FILTER_SAMPLE_MAX按上限处理
  *
- * @param en 是否启用滤波
+ * @param f 滤波状态结构体指针
  * @param sample 样本值
- * @param die 死区阈值（偏差≤die则滤波，＞die直接用采样值）
- * @param max_err 限幅阈值（偏差＞max_err则丢弃，用旧值）
- * @param pFilter 滤波状态结构体指针
  * @return uint16_t 滤波结果
  */
-uint16_t ewma_filter_update(bool en, uint16_t sample, uint16_t die, uint16_t max_err, ewma_filter_t* pFilter) ;
+uint16_t filter_update(filter_t *f, uint16_t sample);
+
+/**
+ * @brief 获取最近一次滤波输出
+ *
+ * @param f 滤波状态结构体指针
+ * @return uint16_t 滤波结果
+ */
+uint16_t filter_get(const filter_t *f);
 
 #endif /* __FILTER_H__ */
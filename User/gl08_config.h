@@ -11,10 +11,64 @@
 
 // 系统配置
 #define FOSC 24000000UL  // 系统时钟频率 24MHz
-#define BAUD 115200        // 串口波特率
-#define BRT (65536 - (FOSC / BAUD + 2) / 4)  // 波特率定时器重载值
-
-#define UART_PRINT 1  // 串口调试打印，1使能串口打印
+#define BAUD 115200        // 串口默认波特率，运行时可由命令协议切换（Timer2分频由FOSC计算）
+#define UART_AUTOBAUD 0    // 1：上电即启动自动波特率，以收到的第一个同步字节0xA5测量波特率
+
+#define UART_PRINT 0  // 控制任务调试打印，1使能；串口驱动和命令协议始终编译
+
+#define ADC_PWM_TRIGGER 1  // ADC触发方式，1：由PWMB在输出周期的安静点硬件触发；0：软件连续触发
+
+#define PWM_FILTER_ADAPTIVE 1  // PWM输入滤波，1：自适应α-β跟踪滤波；0：移位EWMA
+
+// I2C主机（外部DAC等），1使能；可选引脚均与现有功能冲突，默认关闭
+// I2C_S1：SCL=P1.5，SDA=P1.4（占用通道2 PWM输入）；I2C_S4：SCL=P3.2，SDA=P3.3（占用功率旋钮ADC和D1输出）
+#define I2C_ENABLE 0
+#define I2C_PIN_SEL I2C_S1
+#define I2C_PIN_INIT()                          \
+    do {                                        \
+        P1M1 |= (1 << 4) | (1 << 5);            \
+        P1M0 |= (1 << 4) | (1 << 5);            \
+        P1PU |= (1 << 4) | (1 << 5);            \
+    } while (0)  // 11，模式3，开漏输出，使能内部上拉
+
+// SPI级联模式，1使能：两个通道的外部控制值改由SPI级联帧提供，不再捕获PWM输入；默认关闭
+// SPI_S1：SS=P1.2（与LED共用，LED随SS电平亮灭），MOSI=P1.3，MISO=P1.4（占用通道2 PWM输入），SCLK=P1.5；
+// 与I2C_S1引脚重叠，不能同时使能
+#define SPI_CASCADE_ENABLE 0
+#define SPI_PIN_SEL SPI_S1
+#define SPI_PIN_INIT()                          \
+    do {                                        \
+        P1M1 &= ~(1 << 4);                      \
+        P1M0 |= (1 << 4);                       \
+        P1M1 |= (1 << 2) | (1 << 3) | (1 << 5); \
+        P1M0 &= ~((1 << 2) | (1 << 3) | (1 << 5)); \
+    } while (0)  // MISO 01推挽输出，SS、MOSI、SCLK 10高阻输入
+#define SPI_SS P12   // SS引脚，Timer1中断中采样，两帧之间的无效电平用于帧重同步
+
+#if SPI_CASCADE_ENABLE && I2C_ENABLE
+#error "SPI级联与I2C引脚冲突，不能同时使能"
+#endif
+
+// 软件串口（第二串口，8N1），1使能；PWMB CC6比较中断按3倍波特率运行（9600时28.8kHz），默认关闭
+// TXD=P1.1，RXD=P3.7，均为空闲引脚
+#define SUART_ENABLE 0
+#define SUART_BAUD 9600          // 默认波特率（1200 ~ 19200）
+#define SUART_TXD P11
+#define SUART_RXD P37
+#define SUART_PIN_INIT()                        \
+    do {                                        \
+        P1M1 &= ~(1 << 1);                      \
+        P1M0 |= (1 << 1);                       \
+        P3M1 &= ~(1 << 7);                      \
+        P3M0 &= ~(1 << 7);                      \
+    } while (0)  // TXD 01推挽输出，RXD 00准双向口（带上拉）
+#define UART_PRINT_SUART 1       // SUART_ENABLE=1时控制任务调试打印改由软件串口输出，硬件串口只用于命令协议
+
+// 输出后端，每个通道可选PWM或外部I2C DAC
+#define OUTPUT_BACKEND_PWM 0  // PWMB输出PWM，外部RC滤波得到模拟电压
+#define OUTPUT_BACKEND_DAC 1  // 外部12位I2C DAC直接输出模拟电压（需I2C_ENABLE，芯片型号见bsp_dac.h）
+#define OUTPUT1_BACKEND OUTPUT_BACKEND_PWM  // 通道1(D1)输出后端
+#define OUTPUT2_BACKEND OUTPUT_BACKEND_PWM  // 通道2(D2)输出后端
 
 // 窗口判断宏：判断value与target的差值是否在window范围内
 #define IN_WINDOW(value, target, window) \
@@ -70,9 +124,22 @@
 #define ADC_chanel_10 0x0A  // ADC10，引脚P3.2，采样功率旋钮档位
 #define ADC_chanel_13 0x0D  // ADC13，引脚P3.5，采样波段旋钮1档位
 #define ADC_chanel_14 0x0E  // ADC14，引脚P3.6，采样波段旋钮2档位
+#define ADC_chanel_15 0x0F  // ADC15，内部1.19V参考信号源(BandGap)，用于校准ADC参考电压
 
 #define BAND_SWITCH_1 ADC_chanel_13  // 波段旋钮1映射到ADC13
 #define BAND_SWITCH_2 ADC_chanel_14  // 波段旋钮2映射到ADC14
 #define POWER_SWITCH ADC_chanel_10   // 功率旋钮映射到ADC10
+#define BANDGAP_REF ADC_chanel_15    // 内部参考信号源映射到ADC15
+
+// EEPROM扇区分配（共8个扇区，每扇区512字节）
+#define EEPROM_SECTOR_KNOB_CAL 0  // 扇区0：旋钮校准数据
+#define EEPROM_SECTOR_KV 2        // 扇区2~3：键值配置存储，两个扇区轮换
+
+#define EEPROM_SECTOR_EVENT 4     // 扇区4~7：事件日志，四个扇区循环
+
+// 键值存储键分配
+#define KV_KEY_OUTPUT1 0  // 通道1掉电保存的输出状态
+#define KV_KEY_OUTPUT2 1  // 通道2掉电保存的输出状态
+#define KV_KEY_PARAM_BASE 2  // 运行参数，键2~(2+MAX_PARAM-1)
 
 #endif  // __GL08_CONFIG_H__
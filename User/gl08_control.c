@@ -9,21 +9,28 @@
 #include "bsp_adc.h"
 #include "bsp_pwm.h"
 #include "bsp_uart.h"
+#include "bsp_timer.h"
 #include "filter.h"
+#include "kv_store.h"
+#include "event_log.h"
+#include "gl08_param.h"
+#include "soft_timer.h"
+#include "task.h"
+#include "output.h"
+#include "cascade.h"
 #include "gl08_config.h"
 
 #define DUTY_CNT_MAX PWM_FREQUENCY  // 占空比最大值
 #define DUTY_CNT_MIN 0     			// 占空比最小值
 
-// PWM滤波参数
-#define PWM_FILTER_DIE 10       // 滤波死区阈值
-#define PWM_FILTER_MAX_ERR 500  // 滤波限幅阈值(增大以允许更大的正常波动)
-#define PWM_FILTER_N 4          // 滤波长度N
-#define PWM_OUTPUT_THRESHOLD 5  // 输出抖动阈值
+// PWM滤波类型，移位位数、死区和限幅阈值见运行参数表
+#if PWM_FILTER_ADAPTIVE
+#define PWM_FILTER_TYPE FILTER_ALPHA_BETA
+#else
+#define PWM_FILTER_TYPE FILTER_EWMA
+#endif
 
 // PWM捕获超时相关宏定义
-#define PWM_TIMEOUT_THRESHOLD  2    // 超时阈值（2个控制任务周期）
-#define PWM_DC_LEVEL_CNT     3    // 直流电平稳定计数阈值
 #define PWM_DUTY_CHANGE_THRESHOLD  10  // 占空比变化阈值
 
 // 占空比端点锁定宏定义
@@ -34,6 +41,10 @@
 #define PWM_ZONE_STABLE_ENTER_CNT  2  // 进入区域稳定计数阈值
 #define PWM_ZONE_STABLE_EXIT_CNT   4  // 退出区域稳定计数阈值
 
+// 输出状态掉电保存宏定义
+#define OUTPUT_SAVE_STABLE_MS  3000  // 输出状态稳定3000ms后才保存，按上电毫秒数计，与控制任务实际运行间隔无关
+#define OUTPUT_SAVE_TOLERANCE  10    // 输出变化不超过该值视为未变化
+
 // 输出窗口判断宏：判断输出值和当前值的差值是否超过阈值
 #define OUTPUT_NEED_UPDATE(current, output, threshold) \
     ((uint16_t)((output) > (current) ? (output) - (current) : (current) - (output)) >= (threshold))
@@ -45,46 +56,25 @@ typedef enum {
     DUTY_ZONE_HIGH_LOCK,    // 锁定 1000
 } duty_zone_t;
 
-// 直流检测状态枚举
-typedef enum {
-    DC_RES_PENDING = 0, // 待定状态，采样确认中
-    DC_RES_LOW,         // 确认是持续低电平 (0% Duty)
-    DC_RES_HIGH         // 确认是持续高电平 (100% Duty)
-} dc_res_t;
-
-// 直流电平滤波结构体
-typedef struct {
-    uint8_t temp_level;  // 临时候选电平
-    uint8_t level_cnt;   // 输入电平稳定计数
-} dc_filter_state_t;
-
 // 占空比端点控制结构体
 typedef struct {
     duty_zone_t zone;           // 占空比端点状态
     uint8_t stable_cnt;         // 占空比端点稳定计数
 } duty_zone_ctrl_t;
 
-// 控制通道数量枚举
-typedef enum { GL08_CHANNEL1 = 0, GL08_CHANNEL2, MAX_CHANNEL } gl08_channel_t;
-
-// 控制状态结构体
+// 掉电保存的输出状态记录（保存在键值存储中）
 typedef struct {
-    uint16_t input_value;   // PWM输入值（归一化到0-1000）
-    uint16_t output_value;  // PWM输出值（归一化到0-1000）
+    uint16_t input_value;   // PWM输入值
+    uint16_t output_value;  // PWM输出值
     uint8_t band_position;  // 波段位置
-    uint8_t control_mode;   // 控制模式
     uint8_t power_limit;    // 功率限制档位
-    uint8_t timeout;        // PWM捕获超时计数
-} control_state_t;
+} output_record_t;
 
 // Global control data
 data control_state_t control_state[MAX_CHANNEL];  // 双通道，两个单独的控制结构体
 
-// PWM捕获滤波器数组
-static data ewma_filter_t pwm_filters[MAX_CHANNEL];
-
-// 直流电平滤波器数组
-static data dc_filter_state_t pwm_dc_filter[MAX_CHANNEL];
+// PWM捕获滤波器数组（EWMA/α-β不需要样本缓冲，状态16字节，放在idata中）
+static idata filter_t pwm_filters[MAX_CHANNEL];
 
 // 占空比端点控制数组
 static data duty_zone_ctrl_t pwm_zone[MAX_CHANNEL];
@@ -92,11 +82,42 @@ static data duty_zone_ctrl_t pwm_zone[MAX_CHANNEL];
 // 上次控制模式，用于检测模式切换
 static data uint8_t last_control_mode[MAX_CHANNEL];
 
+// 上次处理的ADC缓冲切换序号，用于判断是否有新的采样数据
+static data uint8_t last_adc_seq;
+
+// 上次记录到事件日志的边沿活动状态（pwm_activity_t），避免持续直流时重复记录
+static data uint8_t last_dc_res[MAX_CHANNEL];
+
+// 输出状态掉电保存：已保存的记录、待保存的记录和开始稳定的上电毫秒数
+static xdata output_record_t output_saved[MAX_CHANNEL];
+static xdata output_record_t output_pending[MAX_CHANNEL];
+static xdata uint32_t output_stable_ms[MAX_CHANNEL];
+
+// 待写入EEPROM的通道位图，由output_save_task在后台写入
+static data uint8_t output_save_req;
+
+// 本地旋钮（波段/功率）变化后经渐变引擎限速的通道位图，输出到达目标后清除；
+// 外部输入跟踪不限速，直接输出
+static data uint8_t output_fade_req;
+
+// 捕获超时：最近一次取到捕获结果的上电毫秒数（低16位），超时判断按与它的差值
+static xdata uint16_t capture_ms[MAX_CHANNEL];
+
+// 控制任务实际运行间隔的估计值（ms），取新测量值与旧值的较大者，较小时缓慢回落
+static xdata uint16_t control_gap_ms;
+static xdata uint16_t control_start_ms;  // 本次控制任务开始的上电毫秒数（低16位）
+
 // 内部函数声明
 static uint16_t apply_power_limit(uint8_t power_limit, uint16_t value);
 static uint16_t apply_band_setting(uint8_t band_position, uint16_t range);
 static uint16_t apply_endpoint_lock(uint16_t duty_in, duty_zone_ctrl_t* a);
-static dc_res_t dc_level_check(uint8_t current_level, dc_filter_state_t* state);
+static bool output_record_load(uint8_t ch);
+static void output_record_update(uint8_t ch);
+static void band_position_update(uint8_t ch, switch_input_t input, uint16_t adc_code);
+static void control_gap_update(uint16_t gap);
+static uint16_t capture_timeout_ms(void);
+static void capture_timeout_restart(uint8_t ch);
+static void capture_timeout_cb(uint8_t id);
 
 // 控制逻辑结构体初始化
 void control_init(void) {
@@ -104,11 +125,10 @@ void control_init(void) {
 
     // 初始化PWM滤波器和控制数据
     for (i = 0; i < MAX_CHANNEL; i++) {
-        ewma_filter_init(true, 0, PWM_FILTER_N, &pwm_filters[i]);
+        filter_init(&pwm_filters[i], PWM_FILTER_TYPE, param_get(PARAM_FILTER_SHIFT),
+                    param_get(PARAM_FILTER_DIE), param_get(PARAM_FILTER_MAX_ERR), NULL);
 
-        // 初始化直流电平滤波器
-        pwm_dc_filter[i].temp_level = 0;
-        pwm_dc_filter[i].level_cnt = 0;
+        last_dc_res[i] = PWM_ACT_PRESENT;
 
         // 初始化占空比端点控制
         pwm_zone[i].zone = DUTY_ZONE_NORMAL;
@@ -122,112 +142,163 @@ void control_init(void) {
         control_state[i].band_position = BAND_EXT;
         control_state[i].timeout = 0;
         last_control_mode[i] = CONTROL_MODE_EXT;
+
+        // 恢复掉电前的输出状态，无记录时输出保持原有的默认初始占空比
+        if (!output_record_load(i)) {
+            control_state[i].output_value = (i == GL08_CHANNEL1) ? PWM7_DUTY : PWM8_DUTY;
+        }
+    }
+
+    // 初始化旋钮档位检测器
+    switch_init();
+    last_adc_seq = 0;
+    control_gap_ms = 0;
+    output_fade_req = 0;
+}
+
+// 获取通道输出值
+uint16_t control_get_output(uint8_t ch) {
+    return control_state[ch].output_value;
+}
+
+// 获取通道控制状态
+const control_state_t *control_get_state(uint8_t ch) {
+    return &control_state[ch];
+}
+
+// 按当前运行参数重新配置PWM滤波器
+void control_filter_config(void) {
+    uint8_t i;
+
+    for (i = 0; i < MAX_CHANNEL; i++) {
+        filter_init(&pwm_filters[i], PWM_FILTER_TYPE, param_get(PARAM_FILTER_SHIFT),
+                    param_get(PARAM_FILTER_DIE), param_get(PARAM_FILTER_MAX_ERR), NULL);
+        filter_reset(&pwm_filters[i], control_state[i].input_value);  // 从当前输入值继续，避免输出跳变
     }
 }
 
 // 第一次启动转换
 void first_start_conversion(void) {
-    adc_start_conversion(true);  // 强制启动，确保第一次进入控制任务时有数据可用
+    adc_scan_start();  // 启动ADC连续扫描，之后由中断自行运行
+#if !SPI_CASCADE_ENABLE
+    // 级联模式不开捕获：P1.4用作MISO，开捕获会让每个SPI时钟边沿都进捕获中断
     pwma_ic1_start();
     pwma_ic2_start();
+#endif
+
+    // 启动捕获超时定时器，上电无输入信号时超时后记录捕获超时事件
+    capture_timeout_restart(GL08_CHANNEL1);
+    capture_timeout_restart(GL08_CHANNEL2);
 }
 
 // 控制任务主循环
 void control_task(void) {
-    uint16_t adc_raw;
-    uint16_t voltage;
+    uint16_t adc_code;
+    uint8_t adc_seq;
     uint16_t capture_raw;
     uint16_t pwm_value;
     uint16_t target_value;
     uint8_t i;
-    uint8_t raw_level;
-    dc_res_t res;
+    uint8_t act;
+    uint8_t power_limit;
+    bool instant;
+    uint16_t now = (uint16_t)timer_get_uptime_ms();
+
+    // 测量相邻两次控制任务的实际间隔，作为捕获超时的下限
+    if (control_gap_ms) {
+        control_gap_update(now - control_start_ms);
+    }
+    control_start_ms = now;
 
 #if UART_PRINT
     uart_sendstr("====== control task begin ======\r\n");
 #endif
 
-    // 获取波段1 ADC值并转换为档位
-    adc_raw = adc_get_raw_value(BAND_K1_ADC_CHANNEL);
-    if (adc_raw != ADC_NOT_READY) {
-        voltage = adc_to_voltage(adc_raw);
-        control_state[GL08_CHANNEL1].band_position = determine_band_position(voltage);
+    // 根据BandGap采样更新ADC校准系数，消除供电电压跌落对档位判断的影响
+    adc_calibrate();
 #if UART_PRINT
-        uart_print_u16("band1 voltage(mv):", voltage);
+    uart_print_u16("vref(mv):", adc_get_vref());
+#endif
+
+    // 档位检测只在有新的抽取数据时进行，去抖计数按实际采样次数累计
+    adc_seq = adc_get_seq();
+    if (adc_seq != 0 && adc_seq != last_adc_seq) {
+        last_adc_seq = adc_seq;
+
+        // 获取波段1校准ADC码并转换为档位
+        adc_code = adc_get_calibrated_value(BAND_K1_ADC_CHANNEL);
+        band_position_update(GL08_CHANNEL1, SWITCH_BAND1, adc_code);
+#if UART_PRINT
+        uart_print_u16("band1 voltage(mv):", adc_to_voltage(adc_code));
         uart_print_u8("band1 pos:", control_state[GL08_CHANNEL1].band_position);
 #endif
-    }
 
-    // 获取波段2 ADC值并转换为档位
-    adc_raw = adc_get_raw_value(BAND_K2_ADC_CHANNEL);
-    if (adc_raw != ADC_NOT_READY) {
-        voltage = adc_to_voltage(adc_raw);
-        control_state[GL08_CHANNEL2].band_position = determine_band_position(voltage);
+        // 获取波段2校准ADC码并转换为档位
+        adc_code = adc_get_calibrated_value(BAND_K2_ADC_CHANNEL);
+        band_position_update(GL08_CHANNEL2, SWITCH_BAND2, adc_code);
 #if UART_PRINT
-        uart_print_u16("band2 voltage(mv):", voltage);
+        uart_print_u16("band2 voltage(mv):", adc_to_voltage(adc_code));
         uart_print_u8("band2 pos:", control_state[GL08_CHANNEL2].band_position);
 #endif
-    }
 
-    // 获取功率旋钮ADC值并转换为档位
-    adc_raw = adc_get_raw_value(POWER_ADC_CHANNEL);
-    if (adc_raw != ADC_NOT_READY) {
-        voltage = adc_to_voltage(adc_raw);
-        control_state[GL08_CHANNEL1].power_limit = determine_power_position(voltage);
-        control_state[GL08_CHANNEL2].power_limit = determine_power_position(voltage);
+        // 获取功率旋钮校准ADC码并转换为档位，两个通道共用
+        adc_code = adc_get_calibrated_value(POWER_ADC_CHANNEL);
+        power_limit = determine_power_position(adc_code);
+        if (power_limit != control_state[GL08_CHANNEL1].power_limit) {
+            output_fade_req = (1 << MAX_CHANNEL) - 1;  // 功率旋钮变化，两个通道都渐变到新输出
+        }
+        control_state[GL08_CHANNEL1].power_limit = power_limit;
+        control_state[GL08_CHANNEL2].power_limit = power_limit;
 #if UART_PRINT
-        uart_print_u16("power voltage(mv):", voltage);
+        uart_print_u16("power voltage(mv):", adc_to_voltage(adc_code));
         uart_print_u8("power limit:", control_state[GL08_CHANNEL1].power_limit);
 #endif
     }
 
     // 处理两个通道
     for (i = 0; i < MAX_CHANNEL; i++) {
+        instant = false;
         if (control_state[i].band_position == BAND_EXT) {
+#if SPI_CASCADE_ENABLE
+            // 外部控制模式：获取SPI级联帧中本板记录的控制值
+            capture_raw = cascade_get_duty(i);
+#else
             // 外部控制模式：获取PWM捕获值
             if (i == GL08_CHANNEL1) {
                 capture_raw = get_pwm_ic_duty(PWM1);
             } else {
                 capture_raw = get_pwm_ic_duty(PWM2);
             }
+#endif
 
             // 判断是否捕获完成
             if (capture_raw != PWM_CAPTURE_NOT_READY) {
                 // 正常捕获完成
-                control_state[i].timeout = 0;  // 清除超时计数
+                control_state[i].timeout = 0;  // 清除超时标志
+                capture_timeout_restart(i);    // 重新开始超时计时
+                last_dc_res[i] = PWM_ACT_PRESENT;
                 target_value = capture_raw;  // 直接使用捕获值
             } else {
-                // 未捕获完成，进行超时处理
-                control_state[i].timeout++;
-
-                if (control_state[i].timeout >= PWM_TIMEOUT_THRESHOLD) {
-                    control_state[i].timeout = PWM_TIMEOUT_THRESHOLD;
-
-                    // 读取瞬时电平
-                    if (i == GL08_CHANNEL1) {
-                        raw_level = READ_PWM1_INPUT() ? 1 : 0;
-                    } else {
-                        raw_level = READ_PWM2_INPUT() ? 1 : 0;
-                    }
-
-                    // 调用直流电平检测
-                    res = dc_level_check(raw_level, &pwm_dc_filter[i]);
-
-                    if (res == DC_RES_HIGH) {
-                        target_value = DUTY_CNT_MAX;  // 1000 (100%)
-                    } else if (res == DC_RES_LOW) {
-                        target_value = DUTY_CNT_MIN;  // 0 (0%)
-                    } else {
-                        // 待定状态，保持上次值不变
-                        target_value = control_state[i].input_value;
+                // 未捕获完成：按输入边沿活动状态判断，持续电平立即回退到0%或100%
+#if SPI_CASCADE_ENABLE
+                act = PWM_ACT_PRESENT;  // 级联模式不使用PWM输入，没有新记录时保持上次值
+#else
+                act = get_pwm_activity((i == GL08_CHANNEL1) ? PWM1 : PWM2);
+#endif
+                if (act != PWM_ACT_PRESENT) {
+                    if (act != last_dc_res[i]) {
+                        last_dc_res[i] = act;
+                        event_log(EVT_DC_FALLBACK, i, (act == PWM_ACT_STUCK_HIGH) ? DUTY_CNT_MAX : DUTY_CNT_MIN);
                     }
+                    target_value = (act == PWM_ACT_STUCK_HIGH) ? DUTY_CNT_MAX : DUTY_CNT_MIN;
+                    instant = true;  // 输入丢失：跳过滤波和渐变，直接输出直流电平
 #if UART_PRINT
-                    uart_sendstr("PWM timeout, dc_level:");
-                    uart_uint8(raw_level);
+                    uart_sendstr("PWM stuck, level:");
+                    uart_uint8((act == PWM_ACT_STUCK_HIGH) ? 1 : 0);
                     uart_print_u16("target_value:", target_value);
 #endif
                 } else {
-                    // 未达到超时阈值，保持上次值
+                    // 有边沿但尚未取到捕获结果（包括捕获超时），保持上次值
                     target_value = control_state[i].input_value;
                 }
             }
@@ -239,20 +310,22 @@ void control_task(void) {
             if (last_control_mode[i] != CONTROL_MODE_EXT) {
                 // 模式切换时重置相关状态,但不重置滤波器
                 control_state[i].input_value = 0;  // 重置输入值
-                pwm_dc_filter[i].temp_level = 0;    // 重置直流滤波器
-                pwm_dc_filter[i].level_cnt = 0;
-                control_state[i].timeout = 0;      // 重置超时计数
+                control_state[i].timeout = 0;      // 重置超时标志，重新开始超时计时
+                capture_timeout_restart(i);
                 last_control_mode[i] = CONTROL_MODE_EXT;
 #if UART_PRINT
                 uart_sendstr("mode switch to EXT\r\n");
 #endif
             }
 
-            // 检测是否有显著变化
-            if (IN_WINDOW(target_value, control_state[i].input_value, PWM_DUTY_CHANGE_THRESHOLD) == 0) {
-                // 有显著变化，进行滤波更新
-                control_state[i].input_value = ewma_filter_update(
-                    true, target_value, PWM_FILTER_DIE, PWM_FILTER_MAX_ERR, &pwm_filters[i]);
+            if (instant) {
+                // 直流回退不经滤波：滤波器直接置到回退值，信号恢复时从该值开始跟踪
+                filter_reset(&pwm_filters[i], target_value);
+                control_state[i].input_value = target_value;
+            } else if (PWM_FILTER_ADAPTIVE ||
+                       IN_WINDOW(target_value, control_state[i].input_value, PWM_DUTY_CHANGE_THRESHOLD) == 0) {
+                // 有显著变化（自适应跟踪滤波每周期都更新，平稳时由滤波器自身平滑），进行滤波更新
+                control_state[i].input_value = filter_update(&pwm_filters[i], target_value);
 #if UART_PRINT
                 if (i == GL08_CHANNEL1) {
                     uart_print_u16("pwm1 capture:", capture_raw);
@@ -264,6 +337,9 @@ void control_task(void) {
             }
         } else {
             // 本地控制模式：根据波段位置计算输出值
+            if (last_control_mode[i] == CONTROL_MODE_EXT) {
+                soft_timer_stop(SOFT_TIMER_CAPTURE1 + i);  // 本地模式不需要捕获超时
+            }
             last_control_mode[i] = CONTROL_MODE_LOCAL;
             pwm_value = apply_band_setting(control_state[i].band_position, PWM_FREQUENCY);
             // 直接使用计算值（频率固定1KHz，周期=1000）
@@ -285,15 +361,26 @@ void control_task(void) {
         }
 #endif
 
-        // 输出PWM，抖动小于阈值时不输出
-        if (OUTPUT_NEED_UPDATE(control_state[i].output_value, control_state[i].output_value,
-                               PWM_OUTPUT_THRESHOLD)) {
-            if (i == GL08_CHANNEL1) {
-                set_pwm_duty(D1, control_state[i].output_value);
+        // 设置输出，抖动小于阈值时不更新（端点值总是更新）：
+        // 本地模式和旋钮变化后的过渡由渐变引擎限速，防止浪涌；外部输入跟踪和直流回退直接输出
+        if (instant) {
+            output_set_now(i, control_state[i].output_value);
+        } else if (OUTPUT_NEED_UPDATE(output_get(i), control_state[i].output_value,
+                                      param_get(PARAM_OUTPUT_THRESHOLD)) ||
+                   control_state[i].output_value == DUTY_CNT_MIN ||
+                   control_state[i].output_value == DUTY_CNT_MAX) {
+            if (control_state[i].band_position == BAND_EXT && !(output_fade_req & (1 << i))) {
+                output_set_now(i, control_state[i].output_value);
             } else {
-                set_pwm_duty(D2, control_state[i].output_value);
+                output_set(i, control_state[i].output_value);
             }
         }
+        if (output_get_current(i) == output_get(i)) {
+            output_fade_req &= ~(1 << i);  // 旋钮引起的渐变已完成，恢复直接跟踪
+        }
+
+        // 输出状态稳定后保存，掉电重启时恢复
+        output_record_update(i);
     }
 
 #if UART_PRINT
@@ -301,10 +388,33 @@ void control_task(void) {
     uart_sentEnter();
 #endif
 
-    // 重新启动ADC转换和PWM捕获
-    adc_start_conversion(false);  // 非强制模式，避免重复启动
+    // 重新启动PWM捕获（ADC为连续扫描，无需重新启动）
+#if !SPI_CASCADE_ENABLE
     pwma_ic1_start();
     pwma_ic2_start();
+#endif
+
+    // 下一次取捕获结果最早在本次运行结束后一个控制周期，任务被阻塞时间隔随之变长
+    control_gap_update((uint16_t)timer_get_uptime_ms() - control_start_ms + param_get(PARAM_CONTROL_PERIOD));
+}
+
+// 输出状态保存任务
+void output_save_task(void) {
+    uint8_t i;
+
+    for (i = 0; i < MAX_CHANNEL; i++) {
+        if (output_save_req & (1 << i)) {
+            output_save_req &= ~(1 << i);
+            kv_set(KV_KEY_OUTPUT1 + i, (const uint8_t *)&output_saved[i], sizeof(output_record_t));
+        }
+    }
+}
+
+// 控制事件任务
+void control_event_task(void) {
+    if (pwm_take_activity_event()) {
+        Task_Trigger(TASK_CONTROL);  // 输入变为持续电平或恢复，立即执行一次控制任务
+    }
 }
 
 // 应用功率限制，根据功率档位计算功率限制后的值
@@ -403,29 +513,161 @@ static uint16_t apply_endpoint_lock(uint16_t duty_in, duty_zone_ctrl_t* a) {
 }
 
 /**
- * @brief 直流电平检测滤波函数
+ * @brief 从键值存储加载掉电前的输出状态，恢复到控制状态
+ *
+ * @param ch 通道索引
+ * @return true 记录有效并已恢复
+ */
+static bool output_record_load(uint8_t ch) {
+    output_record_t xdata *r = &output_saved[ch];
+
+    output_stable_ms[ch] = timer_get_uptime_ms();
+    if (kv_get(KV_KEY_OUTPUT1 + ch, (uint8_t *)r, sizeof(output_record_t)) != sizeof(output_record_t) ||
+        r->input_value > DUTY_CNT_MAX || r->output_value > DUTY_CNT_MAX ||
+        r->band_position == BAND_NONE || r->band_position > BAND_100 ||
+        r->power_limit == POWER_LIMIT_NONE || r->power_limit > POWER_LIMIT_100) {
+        // 无记录或记录异常：以实际上电输出（默认初始占空比）作为已保存记录，
+        // 稳定在其他状态时才写入，上电即稳定在默认状态时不写
+        r->input_value = 0;
+        r->output_value = (ch == GL08_CHANNEL1) ? PWM7_DUTY : PWM8_DUTY;
+        r->band_position = BAND_EXT;
+        r->power_limit = POWER_LIMIT_100;
+        output_pending[ch] = *r;
+        return false;
+    }
+
+    output_pending[ch] = *r;
+    control_state[ch].input_value = r->input_value;
+    control_state[ch].output_value = r->output_value;
+    control_state[ch].band_position = r->band_position;
+    control_state[ch].power_limit = r->power_limit;
+    control_state[ch].control_mode =
+        (r->band_position == BAND_EXT) ? CONTROL_MODE_EXT : CONTROL_MODE_LOCAL;
+    last_control_mode[ch] = control_state[ch].control_mode;
+    return true;
+}
+
+/**
+ * @brief 输出状态去抖保存：保持不变满OUTPUT_SAVE_STABLE_MS毫秒，且与已保存记录不同时
+ *        请求output_save_task写入EEPROM
+ * @note 写入可能触发键值存储的扇区搬移和擦除，不在控制任务中执行
+ *
+ * @param ch 通道索引
+ */
+static void output_record_update(uint8_t ch) {
+    control_state_t *s = &control_state[ch];
+    output_record_t xdata *p = &output_pending[ch];
+    output_record_t xdata *r = &output_saved[ch];
+
+    // 旋钮处于档位之间时不保存
+    if (s->band_position == BAND_NONE || s->power_limit == POWER_LIMIT_NONE) {
+        output_stable_ms[ch] = timer_get_uptime_ms();
+        return;
+    }
+
+    // 状态仍在变化：更新待保存记录，重新计数
+    if (s->band_position != p->band_position || s->power_limit != p->power_limit ||
+        !IN_WINDOW(s->output_value, p->output_value, OUTPUT_SAVE_TOLERANCE)) {
+        p->input_value = s->input_value;
+        p->output_value = s->output_value;
+        p->band_position = s->band_position;
+        p->power_limit = s->power_limit;
+        output_stable_ms[ch] = timer_get_uptime_ms();
+        return;
+    }
+
+    if (timer_get_uptime_ms() - output_stable_ms[ch] < OUTPUT_SAVE_STABLE_MS) {
+        return;
+    }
+
+    // 稳定且与已保存记录不同才写入
+    if (p->band_position == r->band_position && p->power_limit == r->power_limit &&
+        IN_WINDOW(p->output_value, r->output_value, OUTPUT_SAVE_TOLERANCE)) {
+        return;
+    }
+
+    *r = *p;
+    output_save_req |= 1 << ch;
+}
+
+/**
+ * @brief 更新波段档位，进入无效档位时记录事件
  *
- * @param current_level 当前采样电平 (0 或 1)
- * @param state 直流滤波状态结构体指针
- * @return dc_res_t 直流检测结果
+ * @param ch 通道索引
+ * @param input 波段旋钮输入
+ * @param adc_code 校准后的ADC码
  */
-static dc_res_t dc_level_check(uint8_t current_level, dc_filter_state_t* state) {
-    // 候选值漂移检测：如果当前采样电平跟正在观察的"候选电平"不一样，重新开始
-    if (current_level != state->temp_level) {
-        state->temp_level = current_level;
-        state->level_cnt = 1;  // 重新计数
-        return DC_RES_PENDING;  // 还没确定，让上层保持现状
+static void band_position_update(uint8_t ch, switch_input_t input, uint16_t adc_code) {
+    uint8_t pos = determine_band_position(input, adc_code);
+
+    if (pos == BAND_NONE && control_state[ch].band_position != BAND_NONE) {
+        event_log(EVT_BAND_NONE, ch, adc_code);
+    }
+    if (pos != control_state[ch].band_position) {
+        output_fade_req |= 1 << ch;  // 波段旋钮变化，渐变到新输出
     }
+    control_state[ch].band_position = pos;
+}
+
+/**
+ * @brief 更新控制任务实际运行间隔的估计值：变长立即跟随，变短每次回落差值的1/8
+ *
+ * @param gap 新测量的间隔，单位：ms
+ */
+static void control_gap_update(uint16_t gap) {
+    if (gap >= control_gap_ms) {
+        control_gap_ms = gap;
+    } else {
+        control_gap_ms -= (control_gap_ms - gap + 7) >> 3;
+    }
+}
+
+/**
+ * @brief 当前的捕获超时时间
+ * @note 控制任务每次运行才取一次捕获结果并重新开启捕获，两次取结果的间隔就是任务的实际运行间隔；
+ *       超时时间不足2倍实际间隔时按2倍计，调试打印等阻塞控制任务时正常输入不会被误判超时
+ *
+ * @return uint16_t 超时时间，单位：ms
+ */
+static uint16_t capture_timeout_ms(void) {
+    uint16_t ms = param_get(PARAM_TIMEOUT_THRESHOLD);
+    uint16_t min_ms = control_gap_ms ? control_gap_ms : param_get(PARAM_CONTROL_PERIOD);
 
-    // 累加一致性
-    state->level_cnt++;
+    min_ms <<= 1;
+    return (ms < min_ms) ? min_ms : ms;
+}
 
-    // 达到阈值（确认当前电平是真实的，不是干扰）
-    if (state->level_cnt >= PWM_DC_LEVEL_CNT) {
-        state->level_cnt = PWM_DC_LEVEL_CNT;  // 饱和计数，防止溢出
-        return (current_level == 1) ? DC_RES_HIGH : DC_RES_LOW;
+/**
+ * @brief 取到捕获结果：记录时间，定时器未运行时重新开始超时计时
+ * @note 定时器运行中不重新挂入时间轮，到期时由回调按最近一次捕获时间判断
+ *
+ * @param ch 通道索引
+ */
+static void capture_timeout_restart(uint8_t ch) {
+    capture_ms[ch] = (uint16_t)timer_get_uptime_ms();
+    if (!soft_timer_running(SOFT_TIMER_CAPTURE1 + ch)) {
+        soft_timer_start(SOFT_TIMER_CAPTURE1 + ch, capture_timeout_ms(), 0, capture_timeout_cb);
     }
+}
 
-    // 计数未达标，继续等待
-    return DC_RES_PENDING;
+/**
+ * @brief 捕获超时定时器回调（任务上下文）：距最近一次捕获未到超时时间时按剩余时间重新计时，
+ *        否则置超时标志，只在有输入→超时时记录一次事件
+ *
+ * @param id 定时器编号
+ */
+static void capture_timeout_cb(uint8_t id) {
+    uint8_t ch = id - SOFT_TIMER_CAPTURE1;
+    uint16_t idle = (uint16_t)timer_get_uptime_ms() - capture_ms[ch];
+    uint16_t ms = capture_timeout_ms();
+
+    if (idle < ms) {
+        soft_timer_start(id, ms - idle, 0, capture_timeout_cb);
+        return;
+    }
+
+    if (!control_state[ch].timeout) {
+        control_state[ch].timeout = 1;
+        event_log(EVT_CAPTURE_TIMEOUT, ch, 0);
+    }
 }
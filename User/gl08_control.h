@@ -9,16 +9,64 @@
 
 #include "gl08_config.h"
 
+// 控制通道数量枚举
+typedef enum { GL08_CHANNEL1 = 0, GL08_CHANNEL2, MAX_CHANNEL } gl08_channel_t;
+
+// 控制状态结构体
+typedef struct {
+    uint16_t input_value;   // PWM输入值（归一化到0-1000）
+    uint16_t output_value;  // PWM输出值（归一化到0-1000）
+    uint8_t band_position;  // 波段位置
+    uint8_t control_mode;   // 控制模式
+    uint8_t power_limit;    // 功率限制档位
+    uint8_t timeout;        // PWM捕获超时标志，捕获超时定时器到期时置1
+} control_state_t;
+
 /**
  * @brief 控制逻辑初始化函数
+ * @note 从键值存储恢复掉电前的输出状态，需在kv_init和param_init之后调用
  */
 void control_init(void);
 
 /**
- * @brief 第一次启动ADC转换和输入捕获
+ * @brief 获取通道当前输出值
+ * @note control_init后调用可得到恢复的掉电前输出，用于上电立即启动PWM输出
+ *
+ * @param ch 通道索引，0为通道1，1为通道2
+ * @return 输出占空比 (0 ~ PWM_FREQUENCY)
+ */
+uint16_t control_get_output(uint8_t ch);
+
+/**
+ * @brief 获取通道控制状态（只读），用于遥测
+ *
+ * @param ch 通道索引，0为通道1，1为通道2
+ * @return 控制状态指针
+ */
+const control_state_t *control_get_state(uint8_t ch);
+
+/**
+ * @brief 按当前运行参数重新配置PWM滤波器，滤波状态从当前输入值继续
+ * @note 滤波相关参数修改后由参数模块调用
+ */
+void control_filter_config(void);
+
+/**
+ * @brief 启动ADC连续扫描和第一次输入捕获
  */
 void first_start_conversion(void);
 
+/**
+ * @brief 控制事件任务：输入边沿活动状态变化时立即触发控制任务，不等控制周期到期
+ */
+void control_event_task(void);
+
+/**
+ * @brief 输出状态保存任务：把控制任务判定稳定的输出状态写入键值存储
+ * @note 写入可能触发扇区搬移和擦除（停顿数毫秒），放在低频后台任务中，不阻塞控制任务
+ */
+void output_save_task(void);
+
 /**
  * @brief 控制逻辑主任务函数，包含调光控制、模式切换等核心控制功能
  */
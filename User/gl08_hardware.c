@@ -10,12 +10,25 @@
 #include "bsp_pwm.h"
 #include "bsp_timer.h"
 #include "bsp_uart.h"
+#include "bsp_i2c.h"
+#include "bsp_suart.h"
+
+// 输出硬件初始化函数
+void hardware_output_init(uint16_t duty1, uint16_t duty2) {
+    gpio_init();
+    pwmb_oc_init(duty1, duty2);
+}
 
 // 硬件初始化函数
 void hardware_init(void) {
-    gpio_init();
     adc_init();
-    pwm_init();
+    pwma_ic_init();
     timer_init();
     uart_init();
+#if I2C_ENABLE
+    i2c_init();
+#endif
+#if SUART_ENABLE
+    suart_init(SUART_BAUD);  // 使用PWMB的CC6，需在hardware_output_init之后
+#endif
 }
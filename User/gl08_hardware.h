@@ -10,7 +10,16 @@
 #include "gl08_config.h"
 
 /**
- * @brief 硬件初始化函数，配置所有硬件外设
+ * @brief 输出硬件初始化：配置GPIO并立即启动PWM输出
+ * @note 上电后最先调用，使输出在其余外设初始化之前就恢复到掉电前的状态
+ *
+ * @param duty1 通道1初始占空比
+ * @param duty2 通道2初始占空比
+ */
+void hardware_output_init(uint16_t duty1, uint16_t duty2);
+
+/**
+ * @brief 硬件初始化函数，配置其余硬件外设（ADC、输入捕获、定时器、UART）
  */
 void hardware_init(void);
 
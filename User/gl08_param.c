@@ -0,0 +1,142 @@
+/**
+ * @file gl08_param.c
+ * @brief 运行参数表实现
+ *
+ * @date 2026-02-07
+ */
+#include "gl08_param.h"
+#include "gl08_config.h"
+#include "gl08_control.h"
+#include "bsp_pwm.h"
+#include "kv_store.h"
+#include "task.h"
+#include "bsp_spi.h"
+
+// 参数默认值
+#if PWM_FILTER_ADAPTIVE
+#define PARAM_DEF_FILTER_SHIFT 3   // 平稳时alpha=1/8
+#else
+#define PARAM_DEF_FILTER_SHIFT 2   // 滤波长度N=2^2=4
+#endif
+#define PARAM_DEF_FILTER_DIE 10       // 滤波死区阈值
+#define PARAM_DEF_FILTER_MAX_ERR 500  // 滤波限幅阈值(增大以允许更大的正常波动)
+#define PARAM_DEF_OUTPUT_THRESHOLD 5  // 输出抖动阈值
+#define PARAM_DEF_TIMEOUT_THRESHOLD 12 // 捕获超时12ms（1kHz输入约12个周期），不足2倍控制任务实际运行间隔时按2倍计
+#define PARAM_DEF_CONTROL_PERIOD 5    // 控制任务周期5ms
+#define PARAM_DEF_CASCADE_SLOT 1      // 级联槽位1（链上第一块板）
+
+// 参数表，顺序与param_id_t一致
+static const param_info_t code param_table[MAX_PARAM] = {
+    {PARAM_TYPE_U8, 1, 6, PARAM_DEF_FILTER_SHIFT},                                // PARAM_FILTER_SHIFT
+    {PARAM_TYPE_U16, 0, 200, PARAM_DEF_FILTER_DIE},                               // PARAM_FILTER_DIE
+    {PARAM_TYPE_U16, 10, 1000, PARAM_DEF_FILTER_MAX_ERR},                         // PARAM_FILTER_MAX_ERR
+    {PARAM_TYPE_U8, 0, 50, PARAM_DEF_OUTPUT_THRESHOLD},                           // PARAM_OUTPUT_THRESHOLD
+    {PARAM_TYPE_U16, 5, 2000, PARAM_DEF_TIMEOUT_THRESHOLD},                       // PARAM_TIMEOUT_THRESHOLD
+    {PARAM_TYPE_U16, PWM_FADE_RATE_INSTANT, PWM_FADE_RATE(1000), PWM_FADE_RATE_DEFAULT},  // PARAM_FADE_RATE
+    {PARAM_TYPE_U8, 1, 50, PARAM_DEF_CONTROL_PERIOD},                             // PARAM_CONTROL_PERIOD
+    {PARAM_TYPE_U8, 1, 255, PARAM_DEF_CASCADE_SLOT},                              // PARAM_CASCADE_SLOT
+};
+
+static xdata uint16_t param_values[MAX_PARAM];  // 当前参数值
+
+/**
+ * @brief 参数修改后使其生效
+ *
+ * @param id 参数编号
+ */
+static void param_apply(uint8_t id) {
+    switch (id) {
+    case PARAM_FILTER_SHIFT:
+    case PARAM_FILTER_DIE:
+    case PARAM_FILTER_MAX_ERR:
+        control_filter_config();
+        break;
+
+    case PARAM_FADE_RATE:
+        set_pwm_fade_rate(D1, param_values[PARAM_FADE_RATE]);
+        set_pwm_fade_rate(D2, param_values[PARAM_FADE_RATE]);
+        break;
+
+    case PARAM_CONTROL_PERIOD:
+        Task_Set_Period(TASK_CONTROL, param_values[PARAM_CONTROL_PERIOD]);
+        break;
+
+#if SPI_CASCADE_ENABLE
+    case PARAM_CASCADE_SLOT:
+        spi_cascade_set_slot((uint8_t)param_values[PARAM_CASCADE_SLOT]);
+        break;
+#endif
+
+    default:
+        break;  // 其余参数在控制任务中每周期读取，无需额外处理
+    }
+}
+
+// 加载参数
+void param_init(void) {
+    uint8_t i;
+    uint8_t buf[2];
+    uint16_t value;
+    const param_info_t code *p;
+
+    for (i = 0; i < MAX_PARAM; i++) {
+        p = &param_table[i];
+        param_values[i] = p->def;
+        if (kv_get(KV_KEY_PARAM_BASE + i, buf, sizeof(buf)) != p->type) {
+            continue;  // 未保存或类型已改变，使用默认值
+        }
+        value = (p->type == PARAM_TYPE_U8) ? buf[0] : (((uint16_t)buf[0] << 8) | buf[1]);
+        if (value >= p->min && value <= p->max) {
+            param_values[i] = value;
+        }
+    }
+}
+
+// 应用全部参数
+void param_apply_all(void) {
+    param_apply(PARAM_FADE_RATE);
+    param_apply(PARAM_CONTROL_PERIOD);
+}
+
+// 获取参数描述
+const param_info_t code *param_get_info(uint8_t id) {
+    return (id < MAX_PARAM) ? &param_table[id] : NULL;
+}
+
+// 读取参数值
+uint16_t param_get(uint8_t id) {
+    return param_values[id];
+}
+
+// 修改参数值
+bool param_set(uint8_t id, uint16_t value) {
+    if (id >= MAX_PARAM || value < param_table[id].min || value > param_table[id].max) {
+        return false;
+    }
+    if (param_values[id] != value) {
+        param_values[id] = value;
+        param_apply(id);
+    }
+    return true;
+}
+
+// 保存全部参数
+bool param_save(void) {
+    uint8_t i;
+    uint8_t buf[2];
+    bool ok = true;
+
+    for (i = 0; i < MAX_PARAM; i++) {
+        // 高字节在前，U8参数只保存低字节
+        if (param_table[i].type == PARAM_TYPE_U8) {
+            buf[0] = param_values[i] & 0xFF;
+        } else {
+            buf[0] = param_values[i] >> 8;
+            buf[1] = param_values[i] & 0xFF;
+        }
+        if (!kv_set(KV_KEY_PARAM_BASE + i, buf, param_table[i].type)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
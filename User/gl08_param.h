@@ -0,0 +1,85 @@
+/**
+ * @file gl08_param.h
+ * @brief 运行参数表头文件，集中管理可通过串口协议在线调整的参数
+ * @note 参数值统一以uint16_t存放，类型决定协议中的字节宽度和键值存储中的长度；
+ *       param_set修改后立即生效，param_save写入键值存储后掉电保持。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __GL08_PARAM_H__
+#define __GL08_PARAM_H__
+
+#include "type_def.h"
+
+// 参数编号，键值存储中对应KV_KEY_PARAM_BASE + 编号
+typedef enum {
+    PARAM_FILTER_SHIFT = 0,   // PWM滤波移位位数k
+    PARAM_FILTER_DIE,         // PWM滤波死区阈值
+    PARAM_FILTER_MAX_ERR,     // PWM滤波限幅阈值
+    PARAM_OUTPUT_THRESHOLD,   // 输出抖动阈值
+    PARAM_TIMEOUT_THRESHOLD,  // PWM捕获超时时间，单位：ms
+    PARAM_FADE_RATE,          // 输出渐变速率，Q10.6定点的占空比单位/ms，只限制本地旋钮引起的输出变化
+    PARAM_CONTROL_PERIOD,     // 控制任务周期，单位：ms
+    PARAM_CASCADE_SLOT,       // SPI级联模式下本板的槽位号
+    MAX_PARAM
+} param_id_t;
+
+// 参数类型，取值即协议中的字节宽度
+typedef enum {
+    PARAM_TYPE_U8 = 1,
+    PARAM_TYPE_U16 = 2,
+} param_type_t;
+
+// 参数描述
+typedef struct {
+    uint8_t type;      // 参数类型
+    uint16_t min;      // 最小值
+    uint16_t max;      // 最大值
+    uint16_t def;      // 默认值
+} param_info_t;
+
+/**
+ * @brief 加载参数：先取默认值，再用键值存储中合法的保存值覆盖
+ * @note 需在kv_init之后、control_init之前调用
+ */
+void param_init(void);
+
+/**
+ * @brief 把全部参数应用到外设和调度器（渐变速率、任务周期）
+ * @note 需在hardware_output_init之后调用
+ */
+void param_apply_all(void);
+
+/**
+ * @brief 获取参数描述
+ *
+ * @param id 参数编号
+ * @return 参数描述指针，编号无效返回NULL
+ */
+const param_info_t code *param_get_info(uint8_t id);
+
+/**
+ * @brief 读取参数值
+ *
+ * @param id 参数编号，调用方保证有效
+ * @return uint16_t 参数值
+ */
+uint16_t param_get(uint8_t id);
+
+/**
+ * @brief 修改参数值并立即生效
+ *
+ * @param id 参数编号
+ * @param value 新值
+ * @return true 修改成功；false 编号无效或超出范围
+ */
+bool param_set(uint8_t id, uint16_t value);
+
+/**
+ * @brief 把全部参数写入键值存储，与已存值相同的参数不写EEPROM
+ *
+ * @return true 全部写入成功
+ */
+bool param_save(void);
+
+#endif /* __GL08_PARAM_H__ */
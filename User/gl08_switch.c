@@ -6,32 +6,217 @@
  */
 #include "gl08_switch.h"
 
-// 波段旋钮档位判定函数，输入电压，返回档位
-uint8_t determine_band_position(uint16_t voltage) {
-    if (IN_WINDOW(voltage, BAND_SWITCH_EXT_VOLGATE, BAND_SWITCH_ERR_VOLGATE)) {
-        return BAND_EXT;
-    } else if (IN_WINDOW(voltage, BAND_SWITCH_1_VOLGATE, BAND_SWITCH_ERR_VOLGATE)) {
-        return BAND_0;
-    } else if (IN_WINDOW(voltage, BAND_SWITCH_2_VOLGATE, BAND_SWITCH_ERR_VOLGATE)) {
-        return BAND_25;
-    } else if (IN_WINDOW(voltage, BAND_SWITCH_3_VOLGATE, BAND_SWITCH_ERR_VOLGATE)) {
-        return BAND_50;
-    } else if (IN_WINDOW(voltage, BAND_SWITCH_4_VOLGATE, BAND_SWITCH_ERR_VOLGATE)) {
-        return BAND_75;
-    } else if (IN_WINDOW(voltage, BAND_SWITCH_5_VOLGATE, BAND_SWITCH_ERR_VOLGATE)) {
-        return BAND_100;
-    }
-    return BAND_NONE;  // 默认返回无波段
-}
-
-// 功率旋钮档位判定函数，输入电压，返回档位
-uint8_t determine_power_position(uint16_t voltage) {
-    if (IN_WINDOW(voltage, POWER_SWITCH_1_VOLGATE, POWER_SWITCH_ERR_VOLGATE)) {
-        return POWER_LIMIT_67;
-    } else if (IN_WINDOW(voltage, POWER_SWITCH_2_VOLGATE, POWER_SWITCH_ERR_VOLGATE)) {
-        return POWER_LIMIT_83;
-    } else if (IN_WINDOW(voltage, POWER_SWITCH_3_VOLGATE, POWER_SWITCH_ERR_VOLGATE)) {
-        return POWER_LIMIT_100;
-    }
-    return POWER_LIMIT_NONE;  // 默认返回无功率档位
+// 旋钮档位描述（存放在code区）
+typedef struct {
+    const uint16_t code *centers;   // 默认档位中心ADC码，升序
+    const uint8_t code *positions;  // 每个窗口对应的档位值
+    uint8_t windows;                // 窗口数量
+    uint8_t none;                   // 落在窗口外时的档位值
+    uint16_t err;                   // 窗口半宽（允许误差），单位：ADC码
+} switch_profile_t;
+
+// 波段旋钮默认中心值，按电压升序排列
+static const uint16_t code band_centers[SWITCH_BAND_POSITIONS] = {
+    SWITCH_MV_TO_CODE(BAND_SWITCH_EXT_VOLGATE),
+    SWITCH_MV_TO_CODE(BAND_SWITCH_1_VOLGATE),
+    SWITCH_MV_TO_CODE(BAND_SWITCH_2_VOLGATE),
+    SWITCH_MV_TO_CODE(BAND_SWITCH_3_VOLGATE),
+    SWITCH_MV_TO_CODE(BAND_SWITCH_4_VOLGATE),
+    SWITCH_MV_TO_CODE(BAND_SWITCH_5_VOLGATE),
+};
+
+static const uint8_t code band_positions[SWITCH_BAND_POSITIONS] = {
+    BAND_EXT, BAND_0, BAND_25, BAND_50, BAND_75, BAND_100
+};
+
+// 功率旋钮默认中心值，按电压升序排列
+static const uint16_t code power_centers[SWITCH_POWER_POSITIONS] = {
+    SWITCH_MV_TO_CODE(POWER_SWITCH_1_VOLGATE),
+    SWITCH_MV_TO_CODE(POWER_SWITCH_2_VOLGATE),
+    SWITCH_MV_TO_CODE(POWER_SWITCH_3_VOLGATE),
+};
+
+static const uint8_t code power_positions[SWITCH_POWER_POSITIONS] = {
+    POWER_LIMIT_67, POWER_LIMIT_83, POWER_LIMIT_100
+};
+
+static const switch_profile_t code switch_profiles[MAX_SWITCH] = {
+    {band_centers, band_positions, SWITCH_BAND_POSITIONS, BAND_NONE,
+     SWITCH_MV_TO_CODE(BAND_SWITCH_ERR_VOLGATE)},
+    {band_centers, band_positions, SWITCH_BAND_POSITIONS, BAND_NONE,
+     SWITCH_MV_TO_CODE(BAND_SWITCH_ERR_VOLGATE)},
+    {power_centers, power_positions, SWITCH_POWER_POSITIONS, POWER_LIMIT_NONE,
+     SWITCH_MV_TO_CODE(POWER_SWITCH_ERR_VOLGATE)},
+};
+
+// 各旋钮边界表，每个窗口一对[lo, hi)，启动时生成一次
+static xdata uint16_t switch_bounds[MAX_SWITCH][SWITCH_MAX_POSITIONS * 2];
+
+// 各旋钮档位检测器
+static switch_detector_t switch_detectors[MAX_SWITCH];
+
+/**
+ * @brief 二分查找ADC码所在窗口
+ *
+ * @param bounds 升序边界表
+ * @param windows 窗口数量
+ * @param adc_code 校准后的ADC码
+ * @return 窗口索引，窗口外返回SWITCH_WINDOW_NONE
+ */
+static uint8_t switch_find_window(const uint16_t xdata *bounds, uint8_t windows, uint16_t adc_code) {
+    uint8_t lo = 0;
+    uint8_t hi = windows << 1;
+    uint8_t mid;
+
+    // 统计 bounds 中 <= adc_code 的边界个数
+    while (lo < hi) {
+        mid = (lo + hi) >> 1;
+        if (bounds[mid] <= adc_code) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // 奇数个边界在下方：位于某个窗口的[lo, hi)内
+    return (lo & 1) ? (lo >> 1) : SWITCH_WINDOW_NONE;
+}
+
+/**
+ * @brief 通用档位检测：二分查找窗口，叠加迟滞和去抖
+ *
+ * @param input 旋钮输入
+ * @param adc_code 校准后的ADC码
+ * @return 已确认的档位
+ */
+static uint8_t switch_detect(switch_input_t input, uint16_t adc_code) {
+    const switch_profile_t code *p = &switch_profiles[input];
+    const uint16_t xdata *bounds = switch_bounds[input];
+    switch_detector_t *d = &switch_detectors[input];
+    uint8_t win;
+    uint16_t lo, hi;
+
+    // 迟滞：仍在已确认窗口两侧放宽的范围内，保持不变
+    if (d->window < p->windows) {
+        lo = bounds[d->window << 1];
+        hi = bounds[(d->window << 1) + 1];
+        lo = (lo > SWITCH_HYSTERESIS) ? lo - SWITCH_HYSTERESIS : 0;
+        if (adc_code >= lo && adc_code < hi + SWITCH_HYSTERESIS) {
+            d->count = 0;
+            return d->position;
+        }
+    }
+
+    win = switch_find_window(bounds, p->windows, adc_code);
+
+    // 首个采样直接确认，避免上电等待去抖
+    if (d->window == SWITCH_WINDOW_INIT) {
+        d->count = SWITCH_DEBOUNCE_CNT;
+        d->candidate = win;
+    }
+
+    if (win == d->window) {
+        d->count = 0;
+        return d->position;
+    }
+
+    // 去抖：候选窗口连续N次一致才确认
+    if (win != d->candidate) {
+        d->candidate = win;
+        d->count = 1;
+    } else if (d->count < SWITCH_DEBOUNCE_CNT) {
+        d->count++;
+    }
+
+    if (d->count >= SWITCH_DEBOUNCE_CNT) {
+        d->window = win;
+        d->position = (win == SWITCH_WINDOW_NONE) ? p->none : p->positions[win];
+        d->count = 0;
+    }
+
+    return d->position;
+}
+
+// 初始化所有旋钮的档位检测器
+void switch_init(void) {
+    uint8_t i;
+    uint8_t j;
+    uint16_t centers[SWITCH_MAX_POSITIONS];
+
+    for (i = 0; i < MAX_SWITCH; i++) {
+        for (j = 0; j < switch_profiles[i].windows; j++) {
+            centers[j] = switch_profiles[i].centers[j];
+        }
+        switch_set_centers((switch_input_t)i, centers);
+    }
+}
+
+// 判断各档位中心ADC码是否可用
+bool switch_centers_valid(switch_input_t input, const uint16_t *centers) {
+    uint8_t n = switch_profiles[input].windows;
+    uint8_t i;
+
+    for (i = 1; i < n; i++) {
+        if (centers[i] <= centers[i - 1] || centers[i] - centers[i - 1] < SWITCH_MIN_GAP) {
+            return false;
+        }
+    }
+    // 校准码最大约为2倍满量程，超出说明数据异常
+    return centers[n - 1] < (ADC_RESOLUTION << 1);
+}
+
+// 按各档位中心ADC码重新生成边界表
+bool switch_set_centers(switch_input_t input, const uint16_t *centers) {
+    const switch_profile_t code *p = &switch_profiles[input];
+    uint16_t xdata *bounds = switch_bounds[input];
+    switch_detector_t *d = &switch_detectors[input];
+    uint16_t half;
+    uint16_t gap;
+    uint8_t i;
+
+    // 中心值不可用时保留原边界表
+    if (!switch_centers_valid(input, centers)) {
+        return false;
+    }
+
+    for (i = 0; i < p->windows; i++) {
+        half = p->err;
+        if (i > 0) {
+            gap = (centers[i] - centers[i - 1]) >> 1;
+            if (half >= gap) {
+                half = gap - 1;
+            }
+        }
+        if (i + 1 < p->windows) {
+            gap = (centers[i + 1] - centers[i]) >> 1;
+            if (half >= gap) {
+                half = gap - 1;
+            }
+        }
+        bounds[i << 1] = (centers[i] > half) ? centers[i] - half : 0;
+        bounds[(i << 1) + 1] = centers[i] + half + 1;
+    }
+
+    // 边界表变化后重新确认档位
+    d->position = p->none;
+    d->window = SWITCH_WINDOW_INIT;
+    d->candidate = SWITCH_WINDOW_NONE;
+    d->count = 0;
+
+    return true;
+}
+
+// 获取指定输入的档位数
+uint8_t switch_get_positions(switch_input_t input) {
+    return switch_profiles[input].windows;
+}
+
+// 波段旋钮档位判定函数，输入校准后的ADC码，返回档位
+uint8_t determine_band_position(switch_input_t input, uint16_t adc_code) {
+    return switch_detect(input, adc_code);
+}
+
+// 功率旋钮档位判定函数，输入校准后的ADC码，返回档位
+uint8_t determine_power_position(uint16_t adc_code) {
+    return switch_detect(SWITCH_POWER, adc_code);
 }
@@ -1,6 +1,9 @@
 /**
  * @file gl08_switch.h
  * @brief 旋钮档位模块头文件，实现波段旋钮和功率旋钮的档位读取
+ * @note 档位判定直接在校准后的ADC码上进行：每路输入一张升序边界表，二分查找定位窗口，
+ *       每路输入独立迟滞和N次去抖。边界表在启动时由各档位中心ADC码生成一次存放在RAM中，
+ *       中心值默认由gl08_config.h中的mV常量在编译期换算，EEPROM中有校准数据时以校准数据为准。
  *
  * @date 2026-02-07
  */
@@ -8,21 +11,86 @@
 #define __GL08_SWITCH_H__
 
 #include "gl08_config.h"
+#include "bsp_adc.h"
+
+// 编译期mV→ADC码换算（标称5V参考，12位），四舍五入
+#define SWITCH_MV_TO_CODE(mv) \
+    ((uint16_t)(((uint32_t)(mv) * ADC_RESOLUTION + ADC_VREF_NOMINAL_MV / 2) / ADC_VREF_NOMINAL_MV))
+
+#define SWITCH_BAND_POSITIONS 6   // 波段旋钮档位数：EXT、0%、25%、50%、75%、100%
+#define SWITCH_POWER_POSITIONS 3  // 功率旋钮档位数：66.7%、83.3%、100%
+#define SWITCH_MAX_POSITIONS SWITCH_BAND_POSITIONS
+
+#define SWITCH_HYSTERESIS SWITCH_MV_TO_CODE(50)  // 迟滞宽度：已确认窗口两侧各放宽50mv
+#define SWITCH_MIN_GAP SWITCH_MV_TO_CODE(200)    // 相邻档位中心最小间距，校准数据合法性判断
+#define SWITCH_DEBOUNCE_CNT 2                    // 去抖次数：候选档位连续2次新采样一致才确认
+
+#define SWITCH_WINDOW_NONE 0xFF  // 窗口外
+#define SWITCH_WINDOW_INIT 0xFE  // 尚未采样，首个采样直接确认
+
+// 档位检测器状态（每路输入一个）
+typedef struct {
+    uint8_t position;   // 已确认档位
+    uint8_t window;     // 已确认窗口索引
+    uint8_t candidate;  // 候选窗口索引
+    uint8_t count;      // 候选稳定计数
+} switch_detector_t;
+
+// 旋钮输入枚举定义
+typedef enum {
+    SWITCH_BAND1 = 0,  // 波段旋钮1
+    SWITCH_BAND2,      // 波段旋钮2
+    SWITCH_POWER,      // 功率旋钮
+    MAX_SWITCH
+} switch_input_t;
+
+/**
+ * @brief 初始化所有旋钮的档位检测器，按默认中心值生成边界表
+ */
+void switch_init(void);
+
+/**
+ * @brief 判断各档位中心ADC码是否可用：严格升序且相邻间距不小于SWITCH_MIN_GAP
+ *
+ * @param input 旋钮输入
+ * @param centers 各档位中心ADC码
+ * @return true 可用；false 不可用
+ */
+bool switch_centers_valid(switch_input_t input, const uint16_t *centers);
+
+/**
+ * @brief 按各档位中心ADC码重新生成指定输入的边界表
+ * @note 窗口半宽取允许误差，与相邻档位间距过小时收窄，保证窗口互不重叠
+ *
+ * @param input 旋钮输入
+ * @param centers 各档位中心ADC码，按档位顺序升序排列，个数为switch_get_positions(input)
+ * @return true 生成成功；false 中心值不满足升序或间距过小，边界表保持不变
+ */
+bool switch_set_centers(switch_input_t input, const uint16_t *centers);
+
+/**
+ * @brief 获取指定输入的档位数
+ *
+ * @param input 旋钮输入
+ * @return 档位数
+ */
+uint8_t switch_get_positions(switch_input_t input);
 
 /**
  * @brief 波段档位判定函数
  *
- * @param voltage 输入电压值（单位：mV）
+ * @param input 波段旋钮输入（SWITCH_BAND1或SWITCH_BAND2）
+ * @param adc_code 校准后的ADC码
  * @return 波段档位
  */
-uint8_t determine_band_position(uint16_t voltage);
+uint8_t determine_band_position(switch_input_t input, uint16_t adc_code);
 
 /**
  * @brief 功率档位判定函数
  *
- * @param voltage 输入电压值（单位：mV）
+ * @param adc_code 校准后的ADC码
  * @return 功率档位
  */
-uint8_t determine_power_position(uint16_t voltage);
+uint8_t determine_power_position(uint16_t adc_code);
 
 #endif /* __GL08_SWITCH_H__ */
@@ -0,0 +1,163 @@
+/**
+ * @file knob_cal.c
+ * @brief 旋钮校准模块实现
+ *
+ * @date 2026-02-07
+ */
+#include "knob_cal.h"
+#include "bsp_adc.h"
+#include "bsp_eeprom.h"
+
+static xdata knob_cal_record_t knob_cal_record;  // 校准数据记录缓冲
+static xdata uint8_t knob_cal_step = KNOB_CAL_IDLE;    // 当前校准步骤
+
+/**
+ * @brief 计算记录校验和：除校验和字段外所有字节累加和取反
+ */
+static uint16_t knob_cal_checksum(const knob_cal_record_t xdata *rec) {
+    const uint8_t xdata *p = (const uint8_t xdata *)rec;
+    uint16_t sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(knob_cal_record_t) - sizeof(uint16_t); i++) {
+        sum += p[i];
+    }
+    return ~sum;
+}
+
+/**
+ * @brief 按校准记录生成各旋钮边界表
+ *
+ * @return true 全部旋钮的校准数据可用并已生效
+ */
+static bool knob_cal_apply(void) {
+    uint8_t i;
+
+    // 先全部检查再生效，避免部分旋钮使用校准值
+    for (i = 0; i < MAX_SWITCH; i++) {
+        if (!switch_centers_valid((switch_input_t)i, knob_cal_record.centers[i])) {
+            return false;
+        }
+    }
+    for (i = 0; i < MAX_SWITCH; i++) {
+        switch_set_centers((switch_input_t)i, knob_cal_record.centers[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief 保存校准记录到EEPROM，并回读校验
+ *
+ * @return true 保存成功
+ */
+static bool knob_cal_save(void) {
+    uint16_t addr = EEPROM_SECTOR_ADDR(EEPROM_SECTOR_KNOB_CAL);
+
+    knob_cal_record.magic = KNOB_CAL_MAGIC;
+    knob_cal_record.version = KNOB_CAL_VERSION;
+    knob_cal_record.reserved = 0xFF;
+    knob_cal_record.checksum = knob_cal_checksum(&knob_cal_record);
+
+    eeprom_erase_sector(addr);
+    eeprom_write(addr, (const uint8_t *)&knob_cal_record, sizeof(knob_cal_record_t));
+
+    // 回读校验
+    eeprom_read(addr, (uint8_t *)&knob_cal_record, sizeof(knob_cal_record_t));
+    return knob_cal_record.magic == KNOB_CAL_MAGIC &&
+           knob_cal_record.checksum == knob_cal_checksum(&knob_cal_record);
+}
+
+/**
+ * @brief 记录当前步骤的ADC码
+ *
+ * @param code1 输出：波段旋钮1或功率旋钮的ADC码
+ * @param code2 输出：波段旋钮2的ADC码，功率旋钮步骤为0xFFFF
+ * @return true 记录成功；false 尚无ADC数据
+ */
+static bool knob_cal_sample(uint16_t *code1, uint16_t *code2) {
+    if (knob_cal_step < SWITCH_BAND_POSITIONS) {
+        *code1 = adc_get_calibrated_value(BAND_K1_ADC_CHANNEL);
+        *code2 = adc_get_calibrated_value(BAND_K2_ADC_CHANNEL);
+        if (*code1 == ADC_NOT_READY || *code2 == ADC_NOT_READY) {
+            return false;
+        }
+        knob_cal_record.centers[SWITCH_BAND1][knob_cal_step] = *code1;
+        knob_cal_record.centers[SWITCH_BAND2][knob_cal_step] = *code2;
+    } else {
+        *code1 = adc_get_calibrated_value(POWER_ADC_CHANNEL);
+        *code2 = 0xFFFF;
+        if (*code1 == ADC_NOT_READY) {
+            return false;
+        }
+        knob_cal_record.centers[SWITCH_POWER][knob_cal_step - SWITCH_BAND_POSITIONS] = *code1;
+    }
+    return true;
+}
+
+// 加载EEPROM中的校准数据
+void knob_cal_init(void) {
+    knob_cal_step = KNOB_CAL_IDLE;
+
+    eeprom_read(EEPROM_SECTOR_ADDR(EEPROM_SECTOR_KNOB_CAL), (uint8_t *)&knob_cal_record,
+                sizeof(knob_cal_record_t));
+
+    // 未校准（擦除态0xFF）或数据损坏时保持默认边界表
+    if (knob_cal_record.magic != KNOB_CAL_MAGIC ||
+        knob_cal_record.version != KNOB_CAL_VERSION ||
+        knob_cal_record.checksum != knob_cal_checksum(&knob_cal_record)) {
+        return;
+    }
+    knob_cal_apply();
+}
+
+// 进入校准模式
+void knob_cal_enter(void) {
+    uint8_t i;
+    uint8_t j;
+
+    // 功率旋钮未使用的档位填充擦除值
+    for (i = 0; i < MAX_SWITCH; i++) {
+        for (j = 0; j < SWITCH_MAX_POSITIONS; j++) {
+            knob_cal_record.centers[i][j] = 0xFFFF;
+        }
+    }
+
+    knob_cal_step = 0;
+}
+
+// 获取当前校准步骤
+uint8_t knob_cal_get_step(void) {
+    return knob_cal_step;
+}
+
+// 退出校准模式
+void knob_cal_abort(void) {
+    knob_cal_step = KNOB_CAL_IDLE;  // 档位边界表保持不变
+}
+
+// 记录当前档位
+knob_cal_result_t knob_cal_next(uint16_t *code1, uint16_t *code2) {
+    *code1 = 0xFFFF;
+    *code2 = 0xFFFF;
+    if (knob_cal_step == KNOB_CAL_IDLE) {
+        return KNOB_CAL_ERR_IDLE;
+    }
+
+    if (!knob_cal_sample(code1, code2)) {
+        return KNOB_CAL_ERR_ADC;
+    }
+
+    if (++knob_cal_step < KNOB_CAL_STEPS) {
+        return KNOB_CAL_NEXT;
+    }
+
+    // 全部档位记录完成：检查、生效并保存
+    knob_cal_step = KNOB_CAL_IDLE;
+    if (!knob_cal_apply()) {
+        return KNOB_CAL_ERR_GAP;
+    }
+    if (!knob_cal_save()) {
+        return KNOB_CAL_ERR_EEPROM;
+    }
+    return KNOB_CAL_DONE;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file knob_cal.h
+ * @brief 旋钮校准模块头文件，逐档记录旋钮ADC码并保存到EEPROM
+ * @note 由串口协议的校准命令驱动：进入校准模式后依次把旋钮拨到各档位并发送记录命令，
+ *       先两个波段旋钮同步记录6档，再记录功率旋钮3档。校准数据保存在EEPROM_SECTOR_KNOB_CAL扇区，
+ *       上电时加载并生成档位边界表。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __KNOB_CAL_H__
+#define __KNOB_CAL_H__
+
+#include "type_def.h"
+#include "gl08_switch.h"
+
+// 校准步骤：先两个波段旋钮同步逐档记录，再记录功率旋钮
+#define KNOB_CAL_STEPS (SWITCH_BAND_POSITIONS + SWITCH_POWER_POSITIONS)
+#define KNOB_CAL_IDLE 0xFF  // 非校准模式
+
+// 记录结果
+typedef enum {
+    KNOB_CAL_NEXT = 0,     // 已记录，等待下一档
+    KNOB_CAL_DONE,         // 全部档位记录完成，已生效并保存
+    KNOB_CAL_ERR_IDLE,     // 未处于校准模式
+    KNOB_CAL_ERR_ADC,      // 尚无ADC数据，未记录
+    KNOB_CAL_ERR_GAP,      // 相邻档位过近，校准作废
+    KNOB_CAL_ERR_EEPROM,   // EEPROM写入失败，校准已生效但未保存
+} knob_cal_result_t;
+
+// 校准数据记录标识
+#define KNOB_CAL_MAGIC 0x4B43  // 'K''C'
+#define KNOB_CAL_VERSION 1
+
+// 校准数据记录（保存在EEPROM中）
+typedef struct {
+    uint16_t magic;                                      // 记录标识
+    uint8_t version;                                     // 记录版本
+    uint8_t reserved;                                    // 保留
+    uint16_t centers[MAX_SWITCH][SWITCH_MAX_POSITIONS];  // 各旋钮各档位中心ADC码
+    uint16_t checksum;                                   // 校验和（前面所有字节累加和取反）
+} knob_cal_record_t;
+
+/**
+ * @brief 加载EEPROM中的校准数据，数据有效时按校准值重新生成档位边界表
+ * @note 需在control_init之后调用
+ */
+void knob_cal_init(void);
+
+/**
+ * @brief 进入校准模式，从第一步开始
+ */
+void knob_cal_enter(void);
+
+/**
+ * @brief 获取当前校准步骤
+ *
+ * @return uint8_t 步骤0~KNOB_CAL_STEPS-1，非校准模式返回KNOB_CAL_IDLE
+ */
+uint8_t knob_cal_get_step(void);
+
+/**
+ * @brief 退出校准模式，档位边界表保持不变
+ */
+void knob_cal_abort(void);
+
+/**
+ * @brief 记录当前步骤的旋钮ADC码，最后一步完成后检查、生效并保存
+ *
+ * @param code1 输出：波段旋钮1（功率步骤为功率旋钮）的ADC码
+ * @param code2 输出：波段旋钮2的ADC码，功率步骤为0xFFFF
+ * @return knob_cal_result_t 记录结果
+ */
+knob_cal_result_t knob_cal_next(uint16_t *code1, uint16_t *code2);
+
+#endif /* __KNOB_CAL_H__ */
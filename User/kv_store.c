@@ -0,0 +1,236 @@
+/**
+ * @file kv_store.c
+ * @brief 键值配置存储模块实现
+ *
+ * 扇区格式：
+ *   [0]     扇区头：magic高字节、magic低字节、代数gen、CRC-8
+ *   [4..]   记录：key、len、data[len]、CRC-8(key,len,data)，依次追加
+ *   key为0xFF表示空闲区起点
+ *
+ * @date 2026-02-07
+ */
+#include "kv_store.h"
+#include "crc8.h"
+#include "bsp_eeprom.h"
+
+#define KV_MAGIC 0x4B56                                 // 'K''V'
+#define KV_HDR_SIZE 4                                   // 扇区头长度
+#define KV_REC_OVERHEAD 3                               // 记录额外开销：key、len、crc
+#define KV_REC_MAX (KV_VALUE_MAX + KV_REC_OVERHEAD)     // 单条记录最大长度
+#define KV_KEY_EMPTY 0xFF                               // 擦除态，空闲区起点
+#define KV_FULL EEPROM_SECTOR_SIZE                      // 空闲位置取扇区大小表示已写满
+
+// 搬移后所有键的最新记录加上一条新记录必须能放进一个扇区
+#if (KV_HDR_SIZE + (KV_KEY_MAX + 1) * KV_REC_MAX) > EEPROM_SECTOR_SIZE
+#error "KV_KEY_MAX * KV_VALUE_MAX too large for one EEPROM sector"
+#endif
+
+static xdata uint16_t kv_index[KV_KEY_MAX];  // 每个键最新记录在当前扇区内的偏移，0表示不存在
+static xdata uint8_t kv_rec[KV_REC_MAX];     // 记录读写缓冲
+static xdata uint8_t kv_active = 0;                // 当前扇区（0或1）
+static xdata uint8_t kv_gen = 0;                   // 当前扇区代数
+static xdata uint16_t kv_free = KV_FULL;           // 当前扇区空闲区偏移
+
+// 扇区首地址
+static uint16_t kv_sector_addr(uint8_t sector) {
+    return EEPROM_SECTOR_ADDR(EEPROM_SECTOR_KV + sector);
+}
+
+/**
+ * @brief 读取扇区头
+ *
+ * @param sector 扇区（0或1）
+ * @param gen 输出扇区代数
+ * @return true 扇区头有效
+ */
+static bool kv_read_header(uint8_t sector, uint8_t *gen) {
+    eeprom_read(kv_sector_addr(sector), kv_rec, KV_HDR_SIZE);
+    if (kv_rec[0] != (KV_MAGIC >> 8) || kv_rec[1] != (KV_MAGIC & 0xFF) ||
+        kv_rec[3] != crc8(kv_rec, KV_HDR_SIZE - 1)) {
+        return false;
+    }
+    *gen = kv_rec[2];
+    return true;
+}
+
+// 写扇区头
+static void kv_write_header(uint8_t sector, uint8_t gen) {
+    kv_rec[0] = KV_MAGIC >> 8;
+    kv_rec[1] = KV_MAGIC & 0xFF;
+    kv_rec[2] = gen;
+    kv_rec[3] = crc8(kv_rec, KV_HDR_SIZE - 1);
+    eeprom_write(kv_sector_addr(sector), kv_rec, KV_HDR_SIZE);
+}
+
+/**
+ * @brief 读取当前扇区内偏移处的一条记录到kv_rec
+ *
+ * @param off 记录偏移
+ * @return uint8_t 记录总长度；记录损坏返回0
+ */
+static uint8_t kv_read_record(uint16_t off) {
+    uint16_t addr = kv_sector_addr(kv_active) + off;
+    uint8_t len;
+
+    eeprom_read(addr, kv_rec, 2);
+    len = kv_rec[1];
+    if (len == 0 || len > KV_VALUE_MAX || off + len + KV_REC_OVERHEAD > EEPROM_SECTOR_SIZE) {
+        return 0;
+    }
+    eeprom_read(addr + 2, kv_rec + 2, len + 1);
+    if (kv_rec[len + 2] != crc8(kv_rec, len + 2)) {
+        return 0;
+    }
+    return len + KV_REC_OVERHEAD;
+}
+
+/**
+ * @brief 扫描当前扇区：建立索引并定位空闲区，同一个键后写的记录覆盖先写的
+ */
+static void kv_scan(void) {
+    uint16_t off = KV_HDR_SIZE;
+    uint8_t size;
+    uint8_t i;
+
+    for (i = 0; i < KV_KEY_MAX; i++) {
+        kv_index[i] = 0;
+    }
+
+    while (off + KV_REC_OVERHEAD <= EEPROM_SECTOR_SIZE) {
+        eeprom_read(kv_sector_addr(kv_active) + off, kv_rec, 2);
+        if (kv_rec[0] == KV_KEY_EMPTY) {
+            break;  // 到达空闲区
+        }
+        if (kv_rec[1] == 0 || kv_rec[1] > KV_VALUE_MAX) {
+            off = KV_FULL;  // 长度字段损坏无法跳过，视为写满，下次写入时搬移
+            break;
+        }
+        size = kv_read_record(off);
+        if (size && kv_rec[0] < KV_KEY_MAX) {
+            kv_index[kv_rec[0]] = off;
+        }
+        off += kv_rec[1] + KV_REC_OVERHEAD;  // CRC错误（写入中断）的记录直接跳过
+    }
+
+    kv_free = (off > KV_FULL) ? KV_FULL : off;
+}
+
+/**
+ * @brief 搬移：把每个键的最新记录复制到另一扇区，最后写扇区头使其生效
+ * @note 扇区头写入前掉电，上电时仍使用原扇区，数据不丢失
+ */
+static void kv_compact(void) {
+    uint8_t dst = kv_active ^ 1;
+    uint16_t dst_addr = kv_sector_addr(dst);
+    uint16_t off = KV_HDR_SIZE;
+    uint8_t size;
+    uint8_t i;
+
+    eeprom_erase_sector(dst_addr);
+
+    for (i = 0; i < KV_KEY_MAX; i++) {
+        if (kv_index[i] == 0) {
+            continue;
+        }
+        size = kv_read_record(kv_index[i]);
+        if (size == 0) {
+            kv_index[i] = 0;
+            continue;
+        }
+        eeprom_write(dst_addr + off, kv_rec, size);
+        kv_index[i] = off;
+        off += size;
+    }
+
+    kv_write_header(dst, kv_gen + 1);
+    kv_active = dst;
+    kv_gen++;
+    kv_free = off;
+}
+
+// 初始化存储
+void kv_init(void) {
+    uint8_t gen0;
+    uint8_t gen1;
+    bool ok0 = kv_read_header(0, &gen0);
+    bool ok1 = kv_read_header(1, &gen1);
+
+    if (ok0 && ok1) {
+        // 两个扇区都有效时取代数较新的一个，代数按8位回绕比较
+        kv_active = ((int8_t)(gen1 - gen0) > 0) ? 1 : 0;
+        kv_gen = kv_active ? gen1 : gen0;
+    } else if (ok0 || ok1) {
+        kv_active = ok1 ? 1 : 0;
+        kv_gen = ok1 ? gen1 : gen0;
+    } else {
+        // 首次使用：格式化扇区0
+        kv_active = 0;
+        kv_gen = 0;
+        eeprom_erase_sector(kv_sector_addr(0));
+        kv_write_header(0, 0);
+    }
+
+    kv_scan();
+}
+
+// 读取键的最新值
+uint8_t kv_get(uint8_t key, uint8_t *buf, uint8_t size) {
+    uint8_t len;
+    uint8_t i;
+
+    if (key >= KV_KEY_MAX || kv_index[key] == 0) {
+        return 0;
+    }
+    if (kv_read_record(kv_index[key]) == 0) {
+        return 0;
+    }
+    len = kv_rec[1];
+    if (len > size) {
+        return 0;
+    }
+    for (i = 0; i < len; i++) {
+        buf[i] = kv_rec[2 + i];
+    }
+    return len;
+}
+
+// 写入键值
+bool kv_set(uint8_t key, const uint8_t *buf, uint8_t len) {
+    uint16_t off;
+    uint8_t i;
+
+    if (key >= KV_KEY_MAX || len == 0 || len > KV_VALUE_MAX) {
+        return false;
+    }
+
+    // 与已存值相同则不写，减少擦写
+    if (kv_index[key] && kv_read_record(kv_index[key]) && kv_rec[1] == len) {
+        for (i = 0; i < len && kv_rec[2 + i] == buf[i]; i++) {
+        }
+        if (i == len) {
+            return true;
+        }
+    }
+
+    if (kv_free + len + KV_REC_OVERHEAD > EEPROM_SECTOR_SIZE) {
+        kv_compact();
+    }
+
+    kv_rec[0] = key;
+    kv_rec[1] = len;
+    for (i = 0; i < len; i++) {
+        kv_rec[2 + i] = buf[i];
+    }
+    kv_rec[len + 2] = crc8(kv_rec, len + 2);
+
+    off = kv_free;
+    eeprom_write(kv_sector_addr(kv_active) + off, kv_rec, len + KV_REC_OVERHEAD);
+    kv_free += len + KV_REC_OVERHEAD;
+
+    // 回读校验通过才更新索引，失败时保留旧值
+    if (kv_read_record(off) == 0 || kv_rec[0] != key) {
+        return false;
+    }
+    kv_index[key] = off;
+    return true;
+}
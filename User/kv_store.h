@@ -0,0 +1,45 @@
+/**
+ * @file kv_store.h
+ * @brief 键值配置存储模块头文件，在两个EEPROM扇区上以追加日志方式保存参数
+ * @note 每次写入在当前扇区末尾追加一条带CRC的记录，不擦除扇区；当前扇区写满时把每个键的最新记录
+ *       搬移到另一个扇区（先写记录、最后写扇区头），两个扇区轮换使用，擦写次数分摊到整个扇区。
+ *       上电时扫描一遍当前扇区即可在RAM中建立每个键最新记录的索引，启动耗时有上界。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __KV_STORE_H__
+#define __KV_STORE_H__
+
+#include "type_def.h"
+
+#define KV_KEY_MAX 16    // 键数量，键取值0~KV_KEY_MAX-1
+#define KV_VALUE_MAX 8   // 单条记录值的最大长度
+
+/**
+ * @brief 初始化存储：选出当前扇区并扫描建立索引
+ * @note 需在EA=1之前调用，扫描期间不访问其他外设
+ */
+void kv_init(void);
+
+/**
+ * @brief 读取键的最新值
+ *
+ * @param key 键
+ * @param buf 数据缓冲区
+ * @param size 缓冲区大小
+ * @return uint8_t 值的长度；键不存在或缓冲区不足返回0
+ */
+uint8_t kv_get(uint8_t key, uint8_t *buf, uint8_t size);
+
+/**
+ * @brief 写入键值，与已存值相同时不写EEPROM
+ * @note 当前扇区写满时会触发一次搬移（擦除另一扇区约4ms，CPU暂停）
+ *
+ * @param key 键
+ * @param buf 数据缓冲区
+ * @param len 值的长度（1~KV_VALUE_MAX）
+ * @return true 写入成功；false 参数错误或回读校验失败
+ */
+bool kv_set(uint8_t key, const uint8_t *buf, uint8_t len);
+
+#endif /* __KV_STORE_H__ */
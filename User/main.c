@@ -10,31 +10,61 @@
 #include "gl08_control.h"     // 控制逻辑初始化
 #include "task.h"             // 任务调度
 #include "bsp_led.h"          // LED控制
-#include "isp_trigger.h"      // ISP触发机制
+#include "uart_proto.h"       // 串口命令协议
+#include "knob_cal.h"         // 旋钮校准
+#include "kv_store.h"         // 键值配置存储
+#include "event_log.h"        // 事件日志
+#include "gl08_param.h"       // 运行参数
+#include "soft_timer.h"       // 软件定时器
+#include "output.h"           // 输出后端
+#include "cascade.h"          // SPI级联接收
+#include "bsp_adc.h"          // 出厂BandGap电压值
 
 // 主函数
 int main(void) {
+    bool wdt_reset;
 
+    adc_bgv_mv = *(uint16_t idata *)ADC_BGV_IDATA_ADDR;  // 出厂BandGap电压值，须在任何函数调用使用堆栈之前读取
     EA = 0;          // 关闭总中断
     EAXSFR();        // 使能访问扩展寄存器
 
+    wdt_reset = (WDT_CONTR & WDT_FLAG) ? true : false;  // 看门狗复位标志，system_init中会被清除
+
     // 系统初始化
     system_init();   // 失能硬件看门狗等系统级初始化
 
+    // 上电输出恢复：先读出掉电前的输出状态并立即启动PWM输出，再初始化其余外设，
+    // 避免掉电重启期间输出跳到默认值
+    kv_init();        // 键值配置存储初始化，扫描EEPROM建立索引
+    param_init();     // 加载运行参数
+    control_init();   // 控制逻辑初始化，恢复掉电前的输出状态
+    hardware_output_init(control_get_output(0), control_get_output(1));
+
+    // 事件日志初始化，记录启动事件
+    event_log_init(wdt_reset);
+
+    // 软件定时器初始化，需在Timer1启动前完成
+    soft_timer_init();
+
     // 硬件外设初始化
-    hardware_init();  // GPIO、ADC、PWM、定时器、UART等硬件初始化
+    hardware_init();  // ADC、PWM输入捕获、定时器、UART等硬件初始化
+    param_apply_all();  // 运行参数应用到输出渐变和任务周期
+    output_init();      // 按配置选择各通道输出后端（PWM或I2C DAC）
+#if SPI_CASCADE_ENABLE
+    cascade_init();     // SPI级联接收，按槽位参数启动SPI从机
+#endif
 
     // LED初始化
     led_init();
 
-    // 控制逻辑初始化
-    control_init();
+    // 加载旋钮校准数据，生成档位边界表
+    knob_cal_init();
 
     // 首次启动ADC转换和PWM输入捕获
     first_start_conversion();
 
-    // ISP触发机制初始化
-    isp_trigger_init();
+    // 串口命令协议初始化
+    proto_init();
 
     EA = 1;          // 开启总中断
 
@@ -0,0 +1,105 @@
+/**
+ * @file output.c
+ * @brief 输出后端层实现
+ *
+ * @date 2026-02-07
+ */
+#include "output.h"
+#include "bsp_pwm.h"
+#include "bsp_dac.h"
+#include "gl08_control.h"
+
+#if !I2C_ENABLE && (OUTPUT1_BACKEND == OUTPUT_BACKEND_DAC || OUTPUT2_BACKEND == OUTPUT_BACKEND_DAC)
+#error "DAC输出后端需要I2C_ENABLE=1"
+#endif
+
+static data uint8_t output_backend[MAX_CHANNEL];  // 各通道输出后端
+#if I2C_ENABLE
+static xdata uint16_t output_dac_last[MAX_CHANNEL];  // 上次交给DAC驱动的值，0xFFFF表示需要重新发送
+#endif
+
+// 通道索引转换为PWM输出通道
+#define OUTPUT_PWM_CH(ch) (((ch) == GL08_CHANNEL1) ? D1 : D2)
+
+// 输出后端初始化
+void output_init(void) {
+    output_backend[GL08_CHANNEL1] = OUTPUT_BACKEND_PWM;
+    output_backend[GL08_CHANNEL2] = OUTPUT_BACKEND_PWM;
+#if I2C_ENABLE
+    dac_init();
+#endif
+    output_set_backend(GL08_CHANNEL1, OUTPUT1_BACKEND);
+    output_set_backend(GL08_CHANNEL2, OUTPUT2_BACKEND);
+}
+
+// 设置通道输出目标值
+void output_set(uint8_t ch, uint16_t duty) {
+    set_pwm_duty(OUTPUT_PWM_CH(ch), duty);  // 两种后端都以渐变引擎为准
+}
+
+// 立即设置通道输出值
+void output_set_now(uint8_t ch, uint16_t duty) {
+    set_pwm_duty_now(OUTPUT_PWM_CH(ch), duty);  // DAC后端由output_task在下一个1ms取到新值
+}
+
+// 获取通道输出目标值
+uint16_t output_get(uint8_t ch) {
+    return get_pwm_duty(OUTPUT_PWM_CH(ch));
+}
+
+// 获取通道当前输出值
+uint16_t output_get_current(uint8_t ch) {
+    return get_pwm_output(OUTPUT_PWM_CH(ch));
+}
+
+// 切换通道输出后端
+bool output_set_backend(uint8_t ch, uint8_t backend) {
+    if (ch >= MAX_CHANNEL) {
+        return false;
+    }
+
+    switch (backend) {
+    case OUTPUT_BACKEND_PWM:
+        set_pwm_output_enable(OUTPUT_PWM_CH(ch), true);
+        break;
+
+#if I2C_ENABLE
+    case OUTPUT_BACKEND_DAC:
+        set_pwm_output_enable(OUTPUT_PWM_CH(ch), false);
+        output_dac_last[ch] = 0xFFFF;  // 下一次输出任务立即发送当前值
+        break;
+#endif
+
+    default:
+        return false;
+    }
+
+    output_backend[ch] = backend;
+    return true;
+}
+
+// 获取通道输出后端
+uint8_t output_get_backend(uint8_t ch) {
+    return (ch < MAX_CHANNEL) ? output_backend[ch] : OUTPUT_BACKEND_PWM;
+}
+
+// 输出任务
+void output_task(void) {
+#if I2C_ENABLE
+    uint8_t i;
+    uint16_t duty;
+
+    for (i = 0; i < MAX_CHANNEL; i++) {
+        if (output_backend[i] != OUTPUT_BACKEND_DAC) {
+            continue;
+        }
+        duty = get_pwm_output(OUTPUT_PWM_CH(i));
+        if (duty != output_dac_last[i]) {
+            output_dac_last[i] = duty;
+            // 0~PWM_FREQUENCY映射到12位满量程，四舍五入
+            dac_write(i, (uint16_t)(((uint32_t)duty * DAC_CODE_MAX + PWM_FREQUENCY / 2) / PWM_FREQUENCY));
+        }
+    }
+    dac_poll();
+#endif
+}
@@ -0,0 +1,75 @@
+/**
+ * @file output.h
+ * @brief 输出后端层头文件，控制逻辑通过本层设置两路输出，每路可选PWM或外部I2C DAC
+ * @note 两种后端共用PWMB渐变引擎：output_set()设置目标值，渐变引擎每1ms逼近一步，output_set_now()直接输出；
+ *       PWM后端由渐变引擎直接写比较寄存器，DAC后端由output_task每1ms取渐变引擎的当前值，
+ *       有变化时交给DAC驱动合并发送，DAC通道的PWM引脚关闭输出。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __OUTPUT_H__
+#define __OUTPUT_H__
+
+#include "gl08_config.h"
+
+/**
+ * @brief 输出后端初始化，按gl08_config.h中的OUTPUT1_BACKEND、OUTPUT2_BACKEND选择各通道后端
+ * @note 需在PWM输出和I2C初始化之后调用
+ */
+void output_init(void);
+
+/**
+ * @brief 设置通道输出目标值，由渐变引擎按设定速率逼近
+ *
+ * @param ch 通道索引，0为通道1，1为通道2
+ * @param duty 目标值 (0 ~ PWM_FREQUENCY)
+ */
+void output_set(uint8_t ch, uint16_t duty);
+
+/**
+ * @brief 立即设置通道输出值，不经渐变
+ *
+ * @param ch 通道索引，0为通道1，1为通道2
+ * @param duty 输出值 (0 ~ PWM_FREQUENCY)
+ */
+void output_set_now(uint8_t ch, uint16_t duty);
+
+/**
+ * @brief 获取通道输出目标值
+ *
+ * @param ch 通道索引
+ * @return 最近一次设置的目标值
+ */
+uint16_t output_get(uint8_t ch);
+
+/**
+ * @brief 获取通道当前输出值（渐变过程中的实际值）
+ *
+ * @param ch 通道索引
+ * @return 当前输出值 (0 ~ PWM_FREQUENCY)
+ */
+uint16_t output_get_current(uint8_t ch);
+
+/**
+ * @brief 切换通道输出后端
+ *
+ * @param ch 通道索引
+ * @param backend 输出后端，OUTPUT_BACKEND_PWM或OUTPUT_BACKEND_DAC；未使能I2C时只能选PWM
+ * @return true 切换成功
+ */
+bool output_set_backend(uint8_t ch, uint8_t backend);
+
+/**
+ * @brief 获取通道输出后端
+ *
+ * @param ch 通道索引
+ * @return 输出后端，OUTPUT_BACKEND_PWM或OUTPUT_BACKEND_DAC
+ */
+uint8_t output_get_backend(uint8_t ch);
+
+/**
+ * @brief 输出任务：把DAC通道的渐变当前值交给DAC驱动并推进发送
+ */
+void output_task(void);
+
+#endif /* __OUTPUT_H__ */
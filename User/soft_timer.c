@@ -0,0 +1,166 @@
+/**
+ * @file soft_timer.c
+ * @brief 软件定时器实现
+ *
+ * @date 2026-02-07
+ */
+#include "STC8H.h"
+#include "soft_timer.h"
+
+#define SOFT_TIMER_MASK (SOFT_TIMER_SLOTS - 1)
+#define SOFT_TIMER_SHIFT 4     // log2(SOFT_TIMER_SLOTS)
+#define SOFT_TIMER_NONE 0xFF   // 空链表/未挂入时间轮
+
+#if (1 << SOFT_TIMER_SHIFT) != SOFT_TIMER_SLOTS
+#error "SOFT_TIMER_SHIFT与SOFT_TIMER_SLOTS不一致"
+#endif
+
+// 定时器控制块
+typedef struct {
+    uint16_t rounds;   // 剩余圈数，为0时在所在槽下一次被遍历时到期
+    uint16_t period;   // 周期，0为单次定时
+    uint8_t slot;      // 所在槽，SOFT_TIMER_NONE表示未运行
+    uint8_t prev;      // 链表前一个定时器
+    uint8_t next;      // 链表后一个定时器
+    uint8_t pending;   // 到期未执行回调的次数
+} soft_timer_t;
+
+static xdata soft_timer_t soft_timers[MAX_SOFT_TIMER];
+static xdata soft_timer_cb_t soft_timer_cbs[MAX_SOFT_TIMER];  // 仅任务侧访问
+static xdata uint8_t soft_timer_wheel[SOFT_TIMER_SLOTS];      // 每个槽的链表头
+static data uint8_t soft_timer_cursor = 0;                    // 当前槽，每个滴答加1
+
+// 挂入时间轮：按延时计算槽和圈数，插入槽的链表头
+// 中断和任务都要用，写成宏而不是函数，避免C51不可重入函数被两个上下文调用
+#define SOFT_TIMER_LINK(id, delay)                                          \
+    do {                                                                    \
+        soft_timer_t xdata *t_ = &soft_timers[id];                          \
+        uint8_t s_ = (uint8_t)(soft_timer_cursor + (delay)) & SOFT_TIMER_MASK; \
+        t_->rounds = ((delay) - 1) >> SOFT_TIMER_SHIFT;                     \
+        t_->slot = s_;                                                      \
+        t_->prev = SOFT_TIMER_NONE;                                         \
+        t_->next = soft_timer_wheel[s_];                                    \
+        if (t_->next != SOFT_TIMER_NONE) {                                  \
+            soft_timers[t_->next].prev = (id);                              \
+        }                                                                   \
+        soft_timer_wheel[s_] = (id);                                        \
+    } while (0)
+
+// 从时间轮摘下
+#define SOFT_TIMER_UNLINK(id)                                               \
+    do {                                                                    \
+        soft_timer_t xdata *t_ = &soft_timers[id];                          \
+        if (t_->prev != SOFT_TIMER_NONE) {                                  \
+            soft_timers[t_->prev].next = t_->next;                          \
+        } else {                                                            \
+            soft_timer_wheel[t_->slot] = t_->next;                          \
+        }                                                                   \
+        if (t_->next != SOFT_TIMER_NONE) {                                  \
+            soft_timers[t_->next].prev = t_->prev;                          \
+        }                                                                   \
+        t_->slot = SOFT_TIMER_NONE;                                         \
+    } while (0)
+
+// 软件定时器初始化
+void soft_timer_init(void) {
+    uint8_t i;
+
+    for (i = 0; i < SOFT_TIMER_SLOTS; i++) {
+        soft_timer_wheel[i] = SOFT_TIMER_NONE;
+    }
+    for (i = 0; i < MAX_SOFT_TIMER; i++) {
+        soft_timers[i].slot = SOFT_TIMER_NONE;
+        soft_timers[i].pending = 0;
+        soft_timer_cbs[i] = NULL;
+    }
+    soft_timer_cursor = 0;
+}
+
+// 启动定时器
+void soft_timer_start(uint8_t id, uint16_t delay, uint16_t period, soft_timer_cb_t cb) {
+    bit et1 = ET1;
+
+    if (id >= MAX_SOFT_TIMER) {
+        return;
+    }
+    if (delay == 0) {
+        delay = 1;
+    }
+
+    ET1 = 0;  // 与Timer1中断中的时间轮处理互斥
+    if (soft_timers[id].slot != SOFT_TIMER_NONE) {
+        SOFT_TIMER_UNLINK(id);
+    }
+    soft_timers[id].period = period;
+    soft_timers[id].pending = 0;
+    soft_timer_cbs[id] = cb;
+    SOFT_TIMER_LINK(id, delay);
+    ET1 = et1;
+}
+
+// 停止定时器
+void soft_timer_stop(uint8_t id) {
+    bit et1 = ET1;
+
+    if (id >= MAX_SOFT_TIMER) {
+        return;
+    }
+
+    ET1 = 0;
+    if (soft_timers[id].slot != SOFT_TIMER_NONE) {
+        SOFT_TIMER_UNLINK(id);
+    }
+    soft_timers[id].pending = 0;
+    ET1 = et1;
+}
+
+// 查询定时器是否在运行
+bool soft_timer_running(uint8_t id) {
+    return (id < MAX_SOFT_TIMER && soft_timers[id].slot != SOFT_TIMER_NONE) ? true : false;
+}
+
+// 时间轮滴答（Timer1中断中调用）
+void soft_timer_tick(void) {
+    uint8_t id;
+    uint8_t next;
+
+    soft_timer_cursor = (soft_timer_cursor + 1) & SOFT_TIMER_MASK;
+
+    // 先取出下一个再处理当前定时器；周期定时器重新挂入时插在链表头，本次遍历不会再遇到
+    for (id = soft_timer_wheel[soft_timer_cursor]; id != SOFT_TIMER_NONE; id = next) {
+        next = soft_timers[id].next;
+        if (soft_timers[id].rounds) {
+            soft_timers[id].rounds--;
+            continue;
+        }
+
+        if (soft_timers[id].pending < 0xFF) {
+            soft_timers[id].pending++;
+        }
+        SOFT_TIMER_UNLINK(id);
+        if (soft_timers[id].period) {
+            SOFT_TIMER_LINK(id, soft_timers[id].period);
+        }
+    }
+}
+
+// 执行到期定时器的回调（任务上下文）
+void soft_timer_task(void) {
+    uint8_t i;
+    uint8_t pending;
+    bit et1 = ET1;
+
+    for (i = 0; i < MAX_SOFT_TIMER; i++) {
+        if (soft_timers[i].pending == 0) {
+            continue;
+        }
+        ET1 = 0;
+        pending = soft_timers[i].pending;
+        soft_timers[i].pending = 0;
+        ET1 = et1;
+
+        if (pending && soft_timer_cbs[i] != NULL) {
+            soft_timer_cbs[i](i);
+        }
+    }
+}
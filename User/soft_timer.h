@@ -0,0 +1,72 @@
+/**
+ * @file soft_timer.h
+ * @brief 软件定时器头文件，1ms滴答驱动的哈希时间轮，支持单次和周期定时
+ * @note 定时器按编号静态分配（soft_timer_id_t），启动、停止和每个滴答的到期处理均为O(1)：
+ *       - 时间轮共SOFT_TIMER_SLOTS个槽，定时器按到期时刻挂到对应槽的双向链表上，超过一圈的记录剩余圈数
+ *       - Timer1中断每1ms只遍历当前槽的链表，到期的定时器只置待处理计数，周期定时器重新挂入时间轮
+ *       - 回调由soft_timer_task在任务上下文中执行，回调中可以调用任意任务侧接口
+ *
+ * @date 2026-02-07
+ */
+#ifndef __SOFT_TIMER_H__
+#define __SOFT_TIMER_H__
+
+#include "type_def.h"
+
+#define SOFT_TIMER_SLOTS 16  // 时间轮槽数（2的幂），一圈16ms
+
+// 软件定时器编号，每个使用者占用一个
+typedef enum {
+    SOFT_TIMER_CAPTURE1 = 0,  // 通道1 PWM捕获超时
+    SOFT_TIMER_CAPTURE2,      // 通道2 PWM捕获超时
+    MAX_SOFT_TIMER
+} soft_timer_id_t;
+
+// 定时器回调函数，参数为定时器编号，在任务上下文中执行
+typedef void (*soft_timer_cb_t)(uint8_t id);
+
+/**
+ * @brief 软件定时器初始化，需在Timer1启动前调用
+ */
+void soft_timer_init(void);
+
+/**
+ * @brief 启动（或重新启动）定时器
+ * @note 已在运行的定时器先停止再按新的时间启动，未处理的到期也一并丢弃；
+ *       到期时间以1ms滴答计，实际延时为delay-1 ~ delay ms
+ *
+ * @param id 定时器编号
+ * @param delay 首次到期延时，单位：ms，0按1处理
+ * @param period 周期，单位：ms，0为单次定时
+ * @param cb 到期回调函数，可为NULL（只用soft_timer_running查询）
+ */
+void soft_timer_start(uint8_t id, uint16_t delay, uint16_t period, soft_timer_cb_t cb);
+
+/**
+ * @brief 停止定时器，丢弃尚未执行的回调
+ *
+ * @param id 定时器编号
+ */
+void soft_timer_stop(uint8_t id);
+
+/**
+ * @brief 查询定时器是否在运行（单次定时器到期后即停止）
+ *
+ * @param id 定时器编号
+ * @return true 运行中
+ */
+bool soft_timer_running(uint8_t id);
+
+/**
+ * @brief 时间轮滴答，推进一个槽并处理到期的定时器
+ * @note 仅在Timer1中断中调用
+ */
+void soft_timer_tick(void);
+
+/**
+ * @brief 执行到期定时器的回调
+ * @note 在任务上下文中周期调用；同一定时器多次到期未处理时只回调一次
+ */
+void soft_timer_task(void);
+
+#endif /* __SOFT_TIMER_H__ */
@@ -0,0 +1,61 @@
+/**
+ * @file spsc_queue.h
+ * @brief 单生产者单消费者无锁队列（仅头文件，宏实现）
+ * @note 用于中断向任务（或任务向中断）传递消息，双方均无需关中断：
+ *       - 写入位置head只由生产者修改，读取位置tail只由消费者修改，均为8位，8051上单字节读写是原子的
+ *       - 生产者先写元素再发布head，消费者先读元素再释放tail
+ *       - 容量必须是2的幂且不超过256，实际可存放容量-1个元素
+ *       - 元素可以是任意类型（包括结构体），宏展开后按具体类型直接访问，无函数指针和通用指针开销
+ *
+ *       用法：
+ *         static xdata SPSC_QUEUE(uint16_t, 4) q;   // 定义队列
+ *         SPSC_INIT(q);                             // 初始化（静态变量已清零时可省略）
+ *         if (!SPSC_PUSH(q, value)) { 丢弃计数 }     // 生产者
+ *         while (SPSC_POP(q, value)) { 处理value }   // 消费者
+ *
+ * @date 2026-02-07
+ */
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include "type_def.h"
+
+// 队列类型：head、tail和元素缓冲区放在同一结构体中，由定义处的存储类型决定所在RAM
+#define SPSC_QUEUE(type, size) \
+    struct {                   \
+        volatile uint8_t head; \
+        volatile uint8_t tail; \
+        type buf[size];        \
+    }
+
+// 容量和下标掩码
+#define SPSC_SIZE(q) (sizeof((q).buf) / sizeof((q).buf[0]))
+#define SPSC_MASK(q) ((uint8_t)(SPSC_SIZE(q) - 1))
+#define SPSC_NEXT(q, i) ((uint8_t)((i) + 1) & SPSC_MASK(q))
+
+// 初始化，只能在生产者和消费者都未运行时调用
+#define SPSC_INIT(q) ((q).head = 0, (q).tail = 0)
+
+// 状态查询，生产者和消费者均可调用，结果是调用时刻的快照
+#define SPSC_EMPTY(q) ((q).head == (q).tail)
+#define SPSC_FULL(q) (SPSC_NEXT(q, (q).head) == (q).tail)
+#define SPSC_COUNT(q) ((uint8_t)((q).head - (q).tail) & SPSC_MASK(q))
+
+// 生产者：写入槽位，队列满时该槽位同样可以写（消费者不会读到），适合分多步填写后再发布
+#define SPSC_SLOT(q) ((q).buf[(q).head])
+#define SPSC_COMMIT(q) (SPSC_FULL(q) ? 0 : ((q).head = SPSC_NEXT(q, (q).head), 1))
+
+// 生产者：写入一个元素，返回1成功，0队列满（元素被丢弃）
+#define SPSC_PUSH(q, val) (SPSC_FULL(q) ? 0 : (SPSC_SLOT(q) = (val), (q).head = SPSC_NEXT(q, (q).head), 1))
+
+// 消费者：读取一个元素到var，返回1成功，0队列空
+#define SPSC_POP(q, var) (SPSC_EMPTY(q) ? 0 : ((var) = (q).buf[(q).tail], (q).tail = SPSC_NEXT(q, (q).tail), 1))
+
+// 消费者：原地访问队首元素（队列非空时有效），处理完后用SPSC_RELEASE释放，适合分多步处理的元素
+#define SPSC_FRONT(q) ((q).buf[(q).tail])
+#define SPSC_RELEASE(q) ((q).tail = SPSC_NEXT(q, (q).tail))
+
+// 消费者：丢弃全部未读元素
+#define SPSC_CLEAR(q) ((q).tail = (q).head)
+
+#endif /* __SPSC_QUEUE_H__ */
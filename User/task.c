@@ -8,21 +8,30 @@
 #include "task.h"
 #include "gl08_control.h"
 #include "bsp_led.h"
-#include "isp_trigger.h"
+#include "uart_proto.h"
+#include "event_log.h"
+#include "soft_timer.h"
+#include "output.h"
 
 // 任务结构体
 typedef struct {
     uint8_t Run;             // 任务状态：Run/Stop
+    uint8_t Overrun;         // 超时计数：到期时上一次仍未执行的次数
     uint16_t TIMCount;       // 定时计数器
     uint16_t TRITime;        // 重载计数器
     void (*TaskHook)(void);  // 任务函数
 } TASK_COMPONENTS;
 
-// 任务注册表
+// 任务注册表，顺序与task_id_t一致
 static TASK_COMPONENTS Task_Comps[] = {
-    {0, 5, 5, control_task},  // 5ms 周期，控制任务
-    {0, 1000, 1000, led_task},  // 1000ms 周期，LED 翻转任务
-	{0, 1, 1, isp_trigger_check},  // 1ms周期：ISP口令检测（优先级最高）
+    {0, 0, 5, 5, control_task},  // 5ms 周期，控制任务
+    {0, 0, 1000, 1000, led_task},  // 1000ms 周期，LED 翻转任务
+    {0, 0, 1, 1, proto_task},  // 1ms 周期，串口协议帧解析和遥测发送
+    {0, 0, 10, 10, event_log_task},  // 10ms 周期，事件日志统计和写入
+    {0, 0, 1, 1, soft_timer_task},  // 1ms 周期，执行到期软件定时器的回调
+    {0, 0, 1, 1, control_event_task},  // 1ms 周期，输入边沿活动状态变化时立即触发控制任务
+    {0, 0, 1, 1, output_task},  // 1ms 周期，DAC输出后端跟随渐变引擎并发送
+    {0, 0, 100, 100, output_save_task},  // 100ms 周期，输出状态写入键值存储
 };
 
 // 计算任务数量
@@ -42,6 +51,9 @@ void Task_Marks_Handler_Callback(void) {
             {
                 /*Resume the timer value and try again */
                 Task_Comps[i].TIMCount = Task_Comps[i].TRITime;
+                if (Task_Comps[i].Run && Task_Comps[i].Overrun < 0xFF) {
+                    Task_Comps[i].Overrun++;  /* Previous run still pending */
+                }
                 Task_Comps[i].Run = 1; /* The task can be run */
             }
         }
@@ -62,3 +74,55 @@ void Task_Pro_Handler_Callback(void) {
         }
     }
 }
+
+/**
+ * @brief 读取并清零任务超时计数
+ *
+ */
+uint8_t Task_Take_Overrun(uint8_t idx) {
+    uint8_t cnt;
+    bit et1 = ET1;
+
+    if (idx >= Tasks_Max) {
+        return 0;
+    }
+    ET1 = 0;  // 与Timer1中断中的计数互斥
+    cnt = Task_Comps[idx].Overrun;
+    Task_Comps[idx].Overrun = 0;
+    ET1 = et1;
+    return cnt;
+}
+
+/**
+ * @brief 获取任务数量
+ *
+ */
+uint8_t Task_Get_Count(void) {
+    return Tasks_Max;
+}
+
+/**
+ * @brief 立即触发任务
+ *
+ */
+void Task_Trigger(uint8_t idx) {
+    if (idx >= Tasks_Max) {
+        return;
+    }
+    Task_Comps[idx].Run = 1;  // 单字节写入，与Timer1中断无竞争；周期计数不变
+}
+
+/**
+ * @brief 修改任务周期
+ *
+ */
+void Task_Set_Period(uint8_t idx, uint16_t period) {
+    bit et1 = ET1;
+
+    if (idx >= Tasks_Max || period == 0) {
+        return;
+    }
+    ET1 = 0;  // 与Timer1中断中的重载互斥
+    Task_Comps[idx].TRITime = period;
+    ET1 = et1;
+}
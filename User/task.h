@@ -9,6 +9,18 @@
 
 #include "type_def.h"
 
+// 任务编号，与任务注册表顺序一致
+typedef enum {
+    TASK_CONTROL = 0,  // 控制任务
+    TASK_LED,          // LED翻转任务
+    TASK_PROTO,        // 串口协议任务
+    TASK_EVENT_LOG,    // 事件日志任务
+    TASK_SOFT_TIMER,   // 软件定时器回调任务
+    TASK_CONTROL_EVENT,  // 控制事件任务
+    TASK_OUTPUT,       // 输出后端任务
+    TASK_OUTPUT_SAVE,  // 输出状态保存任务
+} task_id_t;
+
 /**
  * @brief 任务标记回调函数
  */
@@ -19,4 +31,35 @@ void Task_Marks_Handler_Callback(void);
  */
 void Task_Pro_Handler_Callback(void);
 
+/**
+ * @brief 读取并清零任务超时计数（任务到期时上一次仍未执行的次数）
+ *
+ * @param idx 任务表索引
+ * @return uint8_t 超时次数，饱和于255
+ */
+uint8_t Task_Take_Overrun(uint8_t idx);
+
+/**
+ * @brief 获取任务数量
+ *
+ * @return uint8_t 任务表中的任务数量
+ */
+uint8_t Task_Get_Count(void);
+
+/**
+ * @brief 立即触发任务，在下一轮任务处理中执行，不改变周期计数
+ * @note 仅在任务上下文调用
+ *
+ * @param idx 任务表索引
+ */
+void Task_Trigger(uint8_t idx);
+
+/**
+ * @brief 修改任务周期，下一次到期后按新周期运行
+ *
+ * @param idx 任务表索引
+ * @param period 新周期，单位：ms，0忽略
+ */
+void Task_Set_Period(uint8_t idx, uint16_t period);
+
 #endif /* __TASK_H__ */
@@ -0,0 +1,466 @@
+/**
+ * @file uart_proto.c
+ * @brief 串口二进制命令协议实现
+ *
+ * @date 2026-02-07
+ */
+#include "uart_proto.h"
+#include "bsp_uart.h"
+#include "bsp_adc.h"
+#include "bsp_timer.h"
+#include "crc8.h"
+#include "gl08_control.h"
+#include "gl08_param.h"
+#include "knob_cal.h"
+#include "event_log.h"
+#include "isp_trigger.h"
+
+#define PROTO_RX_BUDGET 8          // 每次任务调用最多处理的接收字节数
+#define PROTO_RX_TIMEOUT 10        // 帧内字节间隔超过10ms丢弃半帧，重新等待同步字节
+#define PROTO_TLM_PERIOD_MIN 20    // 遥测最短周期20ms，避免阻塞式发送占满调度
+#define PROTO_BAUD_CONFIRM_MS 2000 // 切换波特率后2s内未收到有效帧则恢复原波特率
+
+// 解析状态
+typedef enum {
+    PROTO_ST_SYNC = 0,  // 等待同步字节
+    PROTO_ST_LEN,       // 等待长度
+    PROTO_ST_CMD,       // 等待命令
+    PROTO_ST_DATA,      // 接收负载
+    PROTO_ST_CRC,       // 等待校验
+} proto_state_t;
+
+static xdata uint8_t proto_state = PROTO_ST_SYNC;  // 解析状态
+static xdata uint8_t proto_len = 0;                // 当前帧负载长度
+static xdata uint8_t proto_cmd = 0;                // 当前帧命令
+static xdata uint8_t proto_idx = 0;                // 负载接收位置
+static xdata uint8_t proto_crc = CRC8_INIT;        // 增量CRC
+static xdata uint16_t proto_rx_ms = 0;             // 最近一次收到字节的上电毫秒数（低16位）
+static xdata uint8_t proto_rx[PROTO_PAYLOAD_MAX];  // 请求负载
+static xdata uint8_t proto_tx[PROTO_PAYLOAD_MAX];  // 应答负载
+
+static xdata uint8_t proto_crc_err = 0;  // CRC错误帧数
+static xdata uint8_t proto_len_err = 0;  // 长度超限帧数
+
+static xdata uint16_t proto_tlm_period = 0;  // 遥测周期，0表示关闭
+static xdata uint16_t proto_tlm_ms = 0;      // 下一帧遥测的计时起点，上电毫秒数（低16位）
+
+static xdata uint32_t proto_baud_prev = 0;     // 切换前的波特率
+static xdata uint8_t proto_baud_confirm = 0;   // 等待新波特率确认
+static xdata uint16_t proto_baud_ms = 0;       // 切换波特率的上电毫秒数（低16位）
+
+// 高字节在前写入16位值
+static void proto_put16(uint8_t xdata *p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+}
+
+// 高字节在前读取16位值
+static uint16_t proto_get16(const uint8_t xdata *p) {
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+// 按参数类型写入参数值，返回写入字节数
+static uint8_t proto_put_value(uint8_t xdata *p, uint8_t type, uint16_t value) {
+    if (type == PARAM_TYPE_U8) {
+        p[0] = value & 0xFF;
+    } else {
+        proto_put16(p, value);
+    }
+    return type;
+}
+
+// 饱和计数
+static void proto_count(uint8_t xdata *cnt) {
+    if (*cnt < 0xFF) {
+        (*cnt)++;
+    }
+}
+
+/**
+ * @brief 发送一帧
+ *
+ * @param cmd 命令
+ * @param buf 负载
+ * @param len 负载长度
+ */
+static void proto_send(uint8_t cmd, const uint8_t xdata *buf, uint8_t len) {
+    uint8_t crc;
+    uint8_t i;
+
+    crc = crc8_update(CRC8_INIT, len);
+    crc = crc8_update(crc, cmd);
+    uart_send(PROTO_SYNC);
+    uart_send(len);
+    uart_send(cmd);
+    for (i = 0; i < len; i++) {
+        uart_send(buf[i]);
+        crc = crc8_update(crc, buf[i]);
+    }
+    uart_send(crc);
+}
+
+// 读参数：id -> id、类型、值、最小值、最大值
+static uint8_t proto_param_get(void) {
+    const param_info_t code *info;
+    uint8_t n;
+
+    if (proto_len != 1) {
+        proto_tx[0] = PROTO_ERR_LEN;
+        return 1;
+    }
+    info = param_get_info(proto_rx[0]);
+    if (info == NULL) {
+        proto_tx[0] = PROTO_ERR_PARAM;
+        return 1;
+    }
+
+    proto_tx[0] = PROTO_OK;
+    proto_tx[1] = proto_rx[0];
+    proto_tx[2] = info->type;
+    n = 3;
+    n += proto_put_value(&proto_tx[n], info->type, param_get(proto_rx[0]));
+    n += proto_put_value(&proto_tx[n], info->type, info->min);
+    n += proto_put_value(&proto_tx[n], info->type, info->max);
+    return n;
+}
+
+// 写参数：id、值 -> id、类型、当前值
+static uint8_t proto_param_set(void) {
+    const param_info_t code *info;
+    uint16_t value;
+
+    if (proto_len == 0) {
+        proto_tx[0] = PROTO_ERR_LEN;
+        return 1;
+    }
+    info = param_get_info(proto_rx[0]);
+    if (info == NULL) {
+        proto_tx[0] = PROTO_ERR_PARAM;
+        return 1;
+    }
+    if (proto_len != 1 + info->type) {
+        proto_tx[0] = PROTO_ERR_LEN;
+        return 1;
+    }
+
+    value = (info->type == PARAM_TYPE_U8) ? proto_rx[1] : proto_get16(&proto_rx[1]);
+    proto_tx[0] = param_set(proto_rx[0], value) ? PROTO_OK : PROTO_ERR_RANGE;
+    proto_tx[1] = proto_rx[0];
+    proto_tx[2] = info->type;
+    return 3 + proto_put_value(&proto_tx[3], info->type, param_get(proto_rx[0]));
+}
+
+// 旋钮校准：子命令 -> 当前步骤、ADC码1、ADC码2
+static uint8_t proto_cal(void) {
+    uint16_t code1 = 0xFFFF;
+    uint16_t code2 = 0xFFFF;
+
+    if (proto_len != 1) {
+        proto_tx[0] = PROTO_ERR_LEN;
+        return 1;
+    }
+
+    proto_tx[0] = PROTO_OK;
+    switch (proto_rx[0]) {
+    case PROTO_CAL_ENTER:
+        knob_cal_enter();
+        break;
+
+    case PROTO_CAL_RECORD:
+        switch (knob_cal_next(&code1, &code2)) {
+        case KNOB_CAL_NEXT:
+        case KNOB_CAL_DONE:
+            break;
+        case KNOB_CAL_ERR_IDLE:
+            proto_tx[0] = PROTO_ERR_STATE;
+            break;
+        case KNOB_CAL_ERR_ADC:
+            proto_tx[0] = PROTO_ERR_NOT_READY;
+            break;
+        case KNOB_CAL_ERR_GAP:
+            proto_tx[0] = PROTO_ERR_RANGE;
+            break;
+        default:
+            proto_tx[0] = PROTO_ERR_FAIL;
+            break;
+        }
+        break;
+
+    case PROTO_CAL_ABORT:
+        knob_cal_abort();
+        break;
+
+    default:
+        proto_tx[0] = PROTO_ERR_PARAM;
+        return 1;
+    }
+
+    // 步骤为KNOB_CAL_IDLE表示已退出校准模式（完成、失败或取消）
+    proto_tx[1] = knob_cal_get_step();
+    proto_put16(&proto_tx[2], code1);
+    proto_put16(&proto_tx[4], code2);
+    return 6;
+}
+
+// 读日志：序号 -> 类型、参数、数据(2字节)、运行时间(4字节)
+static uint8_t proto_log_read(void) {
+    event_record_t rec;
+
+    if (proto_len != 2) {
+        proto_tx[0] = PROTO_ERR_LEN;
+        return 1;
+    }
+    if (!event_log_read(proto_get16(proto_rx), &rec)) {
+        proto_tx[0] = PROTO_END;
+        return 1;
+    }
+
+    proto_tx[0] = PROTO_OK;
+    proto_tx[1] = rec.type;
+    proto_tx[2] = rec.arg;
+    proto_put16(&proto_tx[3], rec.value);
+    proto_put16(&proto_tx[5], (uint16_t)(rec.uptime >> 16));
+    proto_put16(&proto_tx[7], (uint16_t)rec.uptime);
+    return 9;
+}
+
+/**
+ * @brief 切换波特率：先按原波特率发送应答，再切换
+ *
+ * @return true 已发送应答
+ */
+static bool proto_baud(void) {
+    uint32_t baud;
+    int16_t err;
+
+    if (proto_len != 4) {
+        proto_tx[0] = PROTO_ERR_LEN;
+        return false;
+    }
+    baud = ((uint32_t)proto_get16(proto_rx) << 16) | proto_get16(&proto_rx[2]);
+
+    // 0：启动自动波特率，锁定前原波特率仍然有效
+    if (baud == 0) {
+        proto_put16(&proto_tx[1], 0);
+        proto_send(PROTO_CMD_BAUD | PROTO_RSP_FLAG, proto_tx, 3);
+        uart_autobaud_start();
+        return true;
+    }
+
+    err = uart_baud_error(baud);
+    proto_put16(&proto_tx[1], (uint16_t)err);
+    if (err == UART_BAUD_ERR_INVALID || err > UART_BAUD_ERR_MAX || err < -UART_BAUD_ERR_MAX) {
+        proto_tx[0] = PROTO_ERR_RANGE;
+        proto_send(PROTO_CMD_BAUD | PROTO_RSP_FLAG, proto_tx, 3);
+        return true;
+    }
+
+    proto_send(PROTO_CMD_BAUD | PROTO_RSP_FLAG, proto_tx, 3);
+    proto_baud_prev = uart_get_baud();
+    uart_set_baud(baud);
+    proto_baud_confirm = 1;  // 上位机需在新波特率下发送一帧确认
+    proto_baud_ms = (uint16_t)timer_get_uptime_ms();
+    return true;
+}
+
+/**
+ * @brief 执行一条完整的请求帧并发送应答
+ */
+static void proto_dispatch(void) {
+    uint8_t n = 1;
+
+    proto_tx[0] = PROTO_OK;
+    switch (proto_cmd) {
+    case PROTO_CMD_PING:
+        proto_tx[1] = PROTO_VERSION;
+        proto_tx[2] = proto_crc_err;
+        proto_tx[3] = proto_len_err;
+        proto_tx[4] = event_log_get_dropped();
+        proto_tx[5] = uart_get_overrun();
+        proto_tx[6] = uart_get_frame_err();
+        n = 7;
+        break;
+
+    case PROTO_CMD_PARAM_GET:
+        n = proto_param_get();
+        break;
+
+    case PROTO_CMD_PARAM_SET:
+        n = proto_param_set();
+        break;
+
+    case PROTO_CMD_PARAM_SAVE:
+        if (proto_len != 0) {
+            proto_tx[0] = PROTO_ERR_LEN;
+        } else if (!param_save()) {
+            proto_tx[0] = PROTO_ERR_FAIL;
+        }
+        break;
+
+    case PROTO_CMD_TELEMETRY:
+        if (proto_len != 2) {
+            proto_tx[0] = PROTO_ERR_LEN;
+        } else if (proto_get16(proto_rx) != 0 && proto_get16(proto_rx) < PROTO_TLM_PERIOD_MIN) {
+            proto_tx[0] = PROTO_ERR_RANGE;
+        } else {
+            proto_tlm_period = proto_get16(proto_rx);
+            proto_tlm_ms = (uint16_t)timer_get_uptime_ms();
+        }
+        break;
+
+    case PROTO_CMD_BAUD:
+        if (proto_baud()) {
+            return;
+        }
+        break;
+
+    case PROTO_CMD_CAL:
+        n = proto_cal();
+        break;
+
+    case PROTO_CMD_LOG_READ:
+        n = proto_log_read();
+        break;
+
+    case PROTO_CMD_ISP:
+        if (proto_len != 0) {
+            proto_tx[0] = PROTO_ERR_LEN;
+            break;
+        }
+        proto_send(PROTO_CMD_ISP | PROTO_RSP_FLAG, proto_tx, 1);
+        isp_trigger_enter();  // 不再返回
+        return;
+
+    default:
+        proto_tx[0] = PROTO_ERR_CMD;
+        break;
+    }
+
+    proto_send(proto_cmd | PROTO_RSP_FLAG, proto_tx, n);
+}
+
+/**
+ * @brief 解析一个接收字节
+ *
+ * @param dat 接收的字节
+ */
+static void proto_rx_byte(uint8_t dat) {
+    switch (proto_state) {
+    case PROTO_ST_SYNC:
+        if (dat == PROTO_SYNC) {
+            proto_state = PROTO_ST_LEN;
+        }
+        break;
+
+    case PROTO_ST_LEN:
+        if (dat > PROTO_PAYLOAD_MAX) {
+            proto_count(&proto_len_err);
+            proto_state = PROTO_ST_SYNC;
+            break;
+        }
+        proto_len = dat;
+        proto_crc = crc8_update(CRC8_INIT, dat);
+        proto_state = PROTO_ST_CMD;
+        break;
+
+    case PROTO_ST_CMD:
+        proto_cmd = dat;
+        proto_crc = crc8_update(proto_crc, dat);
+        proto_idx = 0;
+        proto_state = (proto_len != 0) ? PROTO_ST_DATA : PROTO_ST_CRC;
+        break;
+
+    case PROTO_ST_DATA:
+        proto_rx[proto_idx++] = dat;
+        proto_crc = crc8_update(proto_crc, dat);
+        if (proto_idx >= proto_len) {
+            proto_state = PROTO_ST_CRC;
+        }
+        break;
+
+    case PROTO_ST_CRC:
+    default:
+        proto_state = PROTO_ST_SYNC;
+        if (dat != proto_crc) {
+            proto_count(&proto_crc_err);
+            break;
+        }
+        proto_baud_confirm = 0;  // 收到有效帧，新波特率确认可用
+        proto_dispatch();
+        break;
+    }
+}
+
+/**
+ * @brief 发送遥测帧：两个通道的输入、输出、波段、功率档位，参考电压，运行时间
+ */
+static void proto_telemetry(void) {
+    const control_state_t *s;
+    uint8_t i;
+    uint8_t n = 0;
+    uint32_t uptime;
+
+    for (i = 0; i < MAX_CHANNEL; i++) {
+        s = control_get_state(i);
+        proto_put16(&proto_tx[n], s->input_value);
+        proto_put16(&proto_tx[n + 2], s->output_value);
+        proto_tx[n + 4] = s->band_position;
+        proto_tx[n + 5] = s->power_limit;
+        n += 6;
+    }
+    proto_put16(&proto_tx[n], adc_get_vref());
+    uptime = timer_get_uptime_ms();
+    proto_put16(&proto_tx[n + 2], (uint16_t)(uptime >> 16));
+    proto_put16(&proto_tx[n + 4], (uint16_t)uptime);
+    proto_send(PROTO_CMD_TELEMETRY_DATA, proto_tx, n + 6);
+}
+
+// 初始化协议解析器
+void proto_init(void) {
+    proto_state = PROTO_ST_SYNC;
+    proto_rx_ms = 0;
+    proto_tlm_period = 0;
+    proto_tlm_ms = 0;
+    proto_baud_confirm = 0;
+    // 注意:此处不能发送数据,因为此时 EA=0,串口中断无法触发,会导致死锁
+}
+
+// 协议任务
+void proto_task(void) {
+    uint8_t buf[PROTO_RX_BUDGET];
+    uint8_t n;
+    uint8_t i;
+    uint16_t now = (uint16_t)timer_get_uptime_ms();  // 各超时均小于65s，用低16位差值判断
+
+    // 自动波特率锁定时丢弃半帧
+    if (uart_autobaud_poll() == UART_AB_LOCKED) {
+        proto_state = PROTO_ST_SYNC;
+    }
+
+    // 新波特率未在规定时间内确认：恢复原波特率
+    if (proto_baud_confirm && (uint16_t)(now - proto_baud_ms) >= PROTO_BAUD_CONFIRM_MS) {
+        proto_baud_confirm = 0;
+        uart_set_baud(proto_baud_prev);
+        proto_state = PROTO_ST_SYNC;
+    }
+
+    n = uart_read(buf, PROTO_RX_BUDGET);
+    if (n) {
+        proto_rx_ms = now;
+        for (i = 0; i < n; i++) {
+            proto_rx_byte(buf[i]);
+        }
+    } else if (proto_state != PROTO_ST_SYNC && (uint16_t)(now - proto_rx_ms) >= PROTO_RX_TIMEOUT) {
+        proto_state = PROTO_ST_SYNC;  // 半帧超时，丢弃
+    }
+
+    // 遥测按上电毫秒数定周期，任务被阻塞时不累积；落后超过一个周期时从当前时刻重新计时，不连发补帧
+    if (proto_tlm_period && (uint16_t)(now - proto_tlm_ms) >= proto_tlm_period) {
+        if ((uint16_t)(now - proto_tlm_ms) - proto_tlm_period >= proto_tlm_period) {
+            proto_tlm_ms = now;
+        } else {
+            proto_tlm_ms += proto_tlm_period;
+        }
+        proto_telemetry();
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file uart_proto.h
+ * @brief 串口二进制命令协议头文件，用于在线调参、遥测、旋钮校准、日志读取和进入ISP
+ * @note 帧格式：[0xA5][LEN][CMD][PAYLOAD×LEN][CRC8]，CRC-8覆盖LEN、CMD和PAYLOAD，多字节字段高字节在前。
+ *       应答帧CMD为请求CMD|0x80，PAYLOAD首字节为状态码；遥测帧由设备按设定周期主动发送。
+ *       解析器在1ms任务中逐字节推进，每次最多处理PROTO_RX_BUDGET个字节，不阻塞调度。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __UART_PROTO_H__
+#define __UART_PROTO_H__
+
+#include "type_def.h"
+
+// 帧格式
+#define PROTO_SYNC 0xA5          // 帧同步字节
+#define PROTO_PAYLOAD_MAX 20     // 负载最大长度
+#define PROTO_RSP_FLAG 0x80      // 应答帧命令标志
+#define PROTO_VERSION 1          // 协议版本
+
+// 命令定义
+typedef enum {
+    PROTO_CMD_PING = 0x01,        // 查询：-> 版本、CRC错误数、长度错误数、日志丢弃数、接收溢出数、帧错误数
+    PROTO_CMD_PARAM_GET = 0x10,   // 读参数：id -> id、类型、值、最小值、最大值
+    PROTO_CMD_PARAM_SET = 0x11,   // 写参数：id、值 -> id、类型、值，立即生效
+    PROTO_CMD_PARAM_SAVE = 0x12,  // 保存全部参数到EEPROM
+    PROTO_CMD_TELEMETRY = 0x20,   // 遥测周期：周期ms(2字节)，0关闭
+    PROTO_CMD_BAUD = 0x21,        // 波特率：波特率(4字节)，0启动自动波特率 -> 误差(0.01%，2字节)
+    PROTO_CMD_CAL = 0x30,         // 旋钮校准：子命令 -> 当前步骤、ADC码1、ADC码2
+    PROTO_CMD_LOG_READ = 0x38,    // 读日志：序号(2字节) -> 8字节记录
+    PROTO_CMD_ISP = 0x3F,         // 进入ISP下载模式，应答后复位
+    PROTO_CMD_TELEMETRY_DATA = 0xC0,  // 遥测帧（设备主动发送）
+} proto_cmd_t;
+
+// 旋钮校准子命令
+typedef enum {
+    PROTO_CAL_ENTER = 0,   // 进入校准模式
+    PROTO_CAL_RECORD,      // 记录当前档位
+    PROTO_CAL_ABORT,       // 退出校准模式
+} proto_cal_sub_t;
+
+// 应答状态码
+typedef enum {
+    PROTO_OK = 0,           // 成功
+    PROTO_ERR_CMD,          // 未知命令
+    PROTO_ERR_LEN,          // 负载长度错误
+    PROTO_ERR_PARAM,        // 参数编号或子命令无效
+    PROTO_ERR_RANGE,        // 数值超出范围（校准：相邻档位过近）
+    PROTO_ERR_STATE,        // 当前状态不允许（校准：未进入校准模式）
+    PROTO_ERR_NOT_READY,    // 数据未就绪（校准：尚无ADC数据）
+    PROTO_ERR_FAIL,         // EEPROM写入失败
+    PROTO_END,              // 读日志：序号超出已有记录数
+} proto_status_t;
+
+/**
+ * @brief 初始化协议解析器
+ * @note 需在uart_init后调用
+ */
+void proto_init(void);
+
+/**
+ * @brief 协议任务：解析接收字节、执行命令、按周期发送遥测帧
+ * @note 需每1ms调用一次
+ */
+void proto_task(void);
+
+#endif /* __UART_PROTO_H__ */
@@ -0,0 +1,41 @@
+#!/bin/sh
+# 构建全固件Linux仿真器
+# 用法：sh sim/build.sh [输出目录]，默认输出到sim/out，可执行文件为<输出目录>/gl08_sim
+# 环境变量：CC 编译器（默认cc），SIM_CFLAGS 附加编译选项
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${1:-$ROOT/sim/out}
+CC=${CC:-cc}
+
+mkdir -p "$OUT/include" "$OUT/src" "$OUT/obj"
+
+# 寄存器定义改为访问仿真存储
+awk -f "$ROOT/sim/stc8h_sfr.awk" "$ROOT/User/STC8H.H" > "$OUT/include/STC8H.h"
+
+COMMON="-std=gnu99 -O2 -g -fno-strict-aliasing -Wall -Wno-unused-function $SIM_CFLAGS"
+INC="-I$OUT/include -I$ROOT/sim/include -I$ROOT/User -I$ROOT/Drivers"
+
+# 固件源文件：去掉中断函数的interrupt N后缀，插桩编译，main改名为firmware_main
+OBJS=""
+for f in "$ROOT"/User/*.c "$ROOT"/Drivers/*.c; do
+    name=$(basename "$f" .c)
+    sed -e 's/)[[:space:]]*interrupt[[:space:]]*[A-Za-z0-9_]*/)/' "$f" > "$OUT/src/$name.c"
+    extra=""
+    if [ "$name" = "main" ]; then
+        extra="-Dmain=firmware_main"
+    fi
+    $CC $COMMON -finstrument-functions -Wno-unknown-pragmas -Wno-pointer-sign -include "$ROOT/sim/include/sim_keil.h" \
+        $INC $extra -c "$OUT/src/$name.c" -o "$OUT/obj/fw_$name.o"
+    OBJS="$OBJS $OUT/obj/fw_$name.o"
+done
+
+# 仿真器源文件，不插桩
+for f in "$ROOT"/sim/*.c; do
+    name=$(basename "$f" .c)
+    $CC $COMMON -I"$ROOT/sim" $INC -c "$f" -o "$OUT/obj/$name.o"
+    OBJS="$OBJS $OUT/obj/$name.o"
+done
+
+$CC $SIM_CFLAGS $OBJS -o "$OUT/gl08_sim"
+echo "$OUT/gl08_sim"
@@ -0,0 +1,31 @@
+/**
+ * @file sim_keil.h
+ * @brief Keil C51扩展关键字和内部函数的主机替代，编译固件源文件时由-include强制包含
+ * @note 存储类型关键字去掉，code映射为const，bit映射为8位整数；
+ *       _nop_()调用仿真器，延时循环由此推进虚拟时间；
+ *       EEPROM的MOVC映射区和idata中的BandGap出厂值改为指向仿真器中的存储。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __SIM_KEIL_H__
+#define __SIM_KEIL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define data
+#define idata
+#define xdata
+#define pdata
+#define code const
+#define bit uint8_t
+
+void sim_nop(void);
+#define _nop_() sim_nop()
+
+extern uint8_t sim_eeprom[];
+extern uint16_t sim_bgv_mv;
+#define EEPROM_MOVC_OFFSET ((uintptr_t)sim_eeprom)
+#define ADC_BGV_IDATA_ADDR ((uintptr_t)&sim_bgv_mv)
+
+#endif /* __SIM_KEIL_H__ */
@@ -0,0 +1,41 @@
+/**
+ * @file sim_sfr.h
+ * @brief 仿真寄存器存储，由生成的STC8H.h包含
+ * @note sfr映射到sim_sfr[地址]，sbit是对所在字节的位域访问，读写同一份存储，位和字节始终一致；
+ *       扩展SFR（xdata 0xF800~0xFFFF）映射到sim_xsfr，16位寄存器按主机字节序整体读写，
+ *       固件只整体访问16位寄存器，不会与高低字节拆分访问混用。
+ *       SBUF单独映射为16位单元：外设模型写入0x100|接收字节，固件写入的值小于0x100，
+ *       模型据此区分发送写入和接收读取。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __SIM_SFR_H__
+#define __SIM_SFR_H__
+
+#include <stdint.h>
+
+#define SIM_XSFR_BASE 0xF800  // 扩展SFR映射区起始地址
+#define SIM_XSFR_SIZE 0x0800  // 扩展SFR映射区大小
+
+// sbit位域，位0为最低位
+typedef struct {
+    uint8_t b0 : 1;
+    uint8_t b1 : 1;
+    uint8_t b2 : 1;
+    uint8_t b3 : 1;
+    uint8_t b4 : 1;
+    uint8_t b5 : 1;
+    uint8_t b6 : 1;
+    uint8_t b7 : 1;
+} sim_sbit_t;
+
+extern volatile uint8_t sim_sfr[256];
+extern volatile uint8_t sim_xsfr[SIM_XSFR_SIZE];
+extern volatile uint16_t sim_sbuf;
+
+#define SIM_SFR(addr) (sim_sfr[addr])
+#define SIM_SBIT(addr, n) (((volatile sim_sbit_t *)&sim_sfr[addr])->b##n)
+#define SIM_XSFR8(addr) (sim_xsfr[(addr) - SIM_XSFR_BASE])
+#define SIM_XSFR16(addr) (*(volatile uint16_t *)&sim_xsfr[(addr) - SIM_XSFR_BASE])
+
+#endif /* __SIM_SFR_H__ */
@@ -0,0 +1,29 @@
+/**
+ * @file type_def.h
+ * @brief 仿真用类型定义，替代User/Type_def.h：C51的int为16位，主机上按stdint定宽类型定义
+ *
+ * @date 2026-02-07
+ */
+#ifndef __TYPE_DEF_H__
+#define __TYPE_DEF_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t u8;    //  8 bits
+typedef uint16_t u16;  // 16 bits
+typedef uint32_t u32;  // 32 bits
+
+#ifndef bool
+#define bool uint8_t
+#endif
+
+#ifndef true
+#define true 1
+#endif
+
+#ifndef false
+#define false 0
+#endif
+
+#endif /* __TYPE_DEF_H__ */
@@ -0,0 +1,149 @@
+/**
+ * @file sim.h
+ * @brief 全固件Linux仿真器内部接口
+ * @note 固件源文件用-finstrument-functions编译，每次函数进入和返回都调用仿真器钩子：
+ *       钩子把虚拟时钟推进一次调用开销，检查固件写过的寄存器，运行到期的外设事件，再按优先级投递中断。
+ *       主循环空转（任务调度函数进入后未调用任何函数即返回）时直接跳到下一个外设事件，
+ *       数小时的运行在几秒内完成。虚拟时间单位为系统时钟周期（1/FOSC）。
+ *
+ * @date 2026-02-07
+ */
+#ifndef __SIM_H__
+#define __SIM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef uint64_t sim_time_t;  // 虚拟时间，单位：系统时钟周期
+
+#define SIM_FOSC 24000000ULL           // 系统时钟频率，与gl08_config.h的FOSC一致
+#define SIM_TIME_MAX UINT64_MAX        // 无事件
+#define SIM_MS(ms) ((sim_time_t)(ms) * (SIM_FOSC / 1000))  // 毫秒换算为时钟周期
+#define SIM_US(us) ((sim_time_t)(us) * (SIM_FOSC / 1000000))  // 微秒换算为时钟周期
+#define SIM_TO_MS(t) ((double)(t) * 1000.0 / SIM_FOSC)    // 时钟周期换算为毫秒
+
+/**
+ * @brief 外设模型
+ * @note poll在每次钩子开始时调用，检测固件写入的寄存器（启动、触发、发送等）；
+ *       next返回下一个事件时间，到期时调用fire；sync在时间推进后更新计数器等只读寄存器。
+ */
+typedef struct {
+    const char *name;
+    void (*poll)(void);
+    sim_time_t (*next)(void);
+    void (*fire)(void);
+    void (*sync)(void);
+} sim_model_t;
+
+extern sim_time_t sim_now;       // 当前虚拟时间
+extern sim_time_t sim_end;       // 仿真结束时间
+extern uint32_t sim_call_cost;   // 每次函数调用折算的时钟周期数
+
+/**
+ * @brief 运行固件：调用固件main，直到仿真结束退出进程
+ */
+void sim_run(void);
+
+/**
+ * @brief 外设模型把CPU停住一段时间（IAP擦写、串口发送等待），在本次钩子中推进，期间不投递中断
+ *
+ * @param cycles 时钟周期数
+ */
+void sim_stall(sim_time_t cycles);
+
+/**
+ * @brief 结束仿真：刷新输出、保存EEPROM、打印统计后退出进程
+ *
+ * @param reason 结束原因
+ */
+void sim_finish(const char *reason);
+
+/**
+ * @brief 打开脚本文件，逐行读取时跳过空行和#注释
+ *
+ * @param path 文件路径
+ * @return FILE* 文件句柄，失败时打印错误并退出
+ */
+FILE *sim_script_open(const char *path);
+
+/**
+ * @brief 读取脚本的下一条有效行
+ *
+ * @param fp 文件句柄
+ * @param buf 行缓冲
+ * @param len 缓冲长度
+ * @param line_no 行号，读取后更新
+ * @return true 读到一行；false 文件结束
+ */
+bool sim_script_line(FILE *fp, char *buf, int len, int *line_no);
+
+// 外设模型，按事件同时到期时的处理顺序排列
+extern const sim_model_t sim_timer_model;
+extern const sim_model_t sim_pwma_model;
+extern const sim_model_t sim_pwmb_model;
+extern const sim_model_t sim_adc_model;
+extern const sim_model_t sim_uart_model;
+extern const sim_model_t sim_iap_model;
+
+/**
+ * @brief 复位外设寄存器为上电默认值
+ */
+void sim_reset_sfr(void);
+
+/**
+ * @brief 加载PWM输入波形脚本，每行：<时间ms> <输入1|2> <频率Hz> <占空比0~1000>
+ *
+ * @param path 脚本路径
+ */
+void sim_pwm_load_wave(const char *path);
+
+/**
+ * @brief 打开PWM输出记录文件，占空比变化时写一行：<时间ms> <D1|D2> <占空比0~1000>
+ *
+ * @param path 文件路径
+ */
+void sim_pwm_open_log(const char *path);
+
+/**
+ * @brief 打印PWM输出统计（各通道时间加权平均占空比）
+ */
+void sim_pwm_report(void);
+
+/**
+ * @brief 加载ADC电压脚本，每行：<时间ms> <通道0~15|vcc> <电压V>
+ *
+ * @param path 脚本路径
+ */
+void sim_adc_load_script(const char *path);
+
+/**
+ * @brief PWMB的OC5REF上升沿触发ADC转换（ADC_EPWMT使能时有效）
+ */
+void sim_adc_pwm_trigger(void);
+
+/**
+ * @brief 选择串口接收数据源
+ *
+ * @param use_stdin true：以非阻塞方式读取stdin；false：不接收
+ */
+void sim_uart_open(bool use_stdin);
+
+/**
+ * @brief 打印串口收发统计
+ */
+void sim_uart_report(void);
+
+/**
+ * @brief 加载EEPROM镜像文件，文件不存在时为全0xFF（已擦除）
+ *
+ * @param path 文件路径，NULL表示不加载也不保存
+ */
+void sim_iap_load(const char *path);
+
+/**
+ * @brief 把EEPROM保存回镜像文件
+ */
+void sim_iap_save(void);
+
+#endif /* __SIM_H__ */
@@ -0,0 +1,150 @@
+/**
+ * @file sim_adc.c
+ * @brief ADC模型：软件启动或PWMB触发，按电压脚本输出10位转换结果
+ * @note 参考电压为VCC，结果 = 通道电压/VCC*1024，第15通道为BandGap（sim_bgv_mv）。
+ *       转换时间按ADCCFG的SPEED分频和ADCTIM的采样时序计算，结果按RESFMT对齐写入ADC_RES/ADC_RESL。
+ *
+ * @date 2026-02-07
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "STC8H.h"
+
+#define SIM_ADC_CHANNELS 16
+#define SIM_ADC_BG_CHANNEL 15  // BandGap通道
+#define SIM_ADC_CH_VCC (-1)    // 脚本中的vcc
+
+// 出厂BandGap电压值，固件通过ADC_BGV_IDATA_ADDR读取
+uint16_t sim_bgv_mv = 1190;
+
+// 电压事件
+typedef struct {
+    sim_time_t t;
+    int ch;  // 0~15，或SIM_ADC_CH_VCC
+    double volts;
+} sim_adc_evt_t;
+
+static sim_adc_evt_t *sim_adc_evts = NULL;
+static size_t sim_adc_num = 0;
+static size_t sim_adc_idx = 0;
+
+static double sim_adc_volts[SIM_ADC_CHANNELS];
+static double sim_adc_vcc = 5.0;
+static bool sim_adc_busy = false;
+static uint8_t sim_adc_ch;
+static sim_time_t sim_adc_done;
+
+// 加载电压脚本
+void sim_adc_load_script(const char *path) {
+    FILE *fp = sim_script_open(path);
+    char buf[256];
+    char name[16];
+    int line_no = 0;
+    double t_ms;
+    double volts;
+
+    while (sim_script_line(fp, buf, sizeof(buf), &line_no)) {
+        sim_adc_evt_t *e;
+        char *end;
+        long ch;
+
+        if (sscanf(buf, "%lf %15s %lf", &t_ms, name, &volts) != 3 || t_ms < 0 || volts < 0) {
+            fprintf(stderr, "%s:%d: 格式应为 <时间ms> <通道0~15|vcc> <电压V>\n", path, line_no);
+            exit(2);
+        }
+        if (strcmp(name, "vcc") == 0) {
+            ch = SIM_ADC_CH_VCC;
+        } else {
+            ch = strtol(name, &end, 0);
+            if (*end != '\0' || ch < 0 || ch >= SIM_ADC_CHANNELS) {
+                fprintf(stderr, "%s:%d: 通道应为0~15或vcc\n", path, line_no);
+                exit(2);
+            }
+        }
+        sim_adc_evts = realloc(sim_adc_evts, (sim_adc_num + 1) * sizeof(*sim_adc_evts));
+        if (sim_adc_evts == NULL) {
+            fprintf(stderr, "内存不足\n");
+            exit(2);
+        }
+        e = &sim_adc_evts[sim_adc_num++];
+        e->t = (sim_time_t)(t_ms * (SIM_FOSC / 1000) + 0.5);
+        e->ch = (int)ch;
+        e->volts = volts;
+        if (sim_adc_num > 1 && e->t < e[-1].t) {
+            fprintf(stderr, "%s:%d: 时间必须递增\n", path, line_no);
+            exit(2);
+        }
+    }
+    fclose(fp);
+}
+
+// 转换时间：ADC时钟 = SYSclk/2/(SPEED+1)，一次转换 = 通道建立 + 保持 + 采样 + 10位逐次比较
+static sim_time_t sim_adc_conv_cycles(void) {
+    uint8_t tim = ADCTIM;
+    uint32_t clocks = ((tim >> 7) & 0x01) + 1 + ((tim >> 5) & 0x03) + 1 + (tim & 0x1F) + 1 + 10;
+
+    return (sim_time_t)clocks * 2 * ((ADCCFG & 0x0F) + 1);
+}
+
+// 启动一次转换，通道在启动时锁存
+static void sim_adc_start(void) {
+    sim_adc_busy = true;
+    sim_adc_ch = ADC_CONTR & 0x0F;
+    sim_adc_done = sim_now + sim_adc_conv_cycles();
+}
+
+// PWMB触发
+void sim_adc_pwm_trigger(void) {
+    if (!sim_adc_busy && (ADC_CONTR & (ADC_POWER | ADC_EPWMT)) == (ADC_POWER | ADC_EPWMT)) {
+        sim_adc_start();
+    }
+}
+
+// 检测软件启动
+static void sim_adc_poll(void) {
+    if (!sim_adc_busy && (ADC_CONTR & (ADC_POWER | ADC_START)) == (ADC_POWER | ADC_START)) {
+        sim_adc_start();
+    }
+}
+
+static sim_time_t sim_adc_next(void) {
+    sim_time_t n = sim_adc_busy ? sim_adc_done : SIM_TIME_MAX;
+
+    if (sim_adc_idx < sim_adc_num && sim_adc_evts[sim_adc_idx].t < n) {
+        n = sim_adc_evts[sim_adc_idx].t;
+    }
+    return n;
+}
+
+// 转换完成：写结果，清START，置FLAG
+static void sim_adc_fire(void) {
+    while (sim_adc_idx < sim_adc_num && sim_adc_evts[sim_adc_idx].t <= sim_now) {
+        const sim_adc_evt_t *e = &sim_adc_evts[sim_adc_idx++];
+
+        if (e->ch == SIM_ADC_CH_VCC) {
+            sim_adc_vcc = e->volts;
+        } else {
+            sim_adc_volts[e->ch] = e->volts;
+        }
+    }
+
+    if (sim_adc_busy && sim_adc_done <= sim_now) {
+        double v = (sim_adc_ch == SIM_ADC_BG_CHANNEL) ? sim_bgv_mv / 1000.0 : sim_adc_volts[sim_adc_ch];
+        double x = (sim_adc_vcc > 0) ? v / sim_adc_vcc * 1024.0 : 0.0;
+        uint16_t res = (x >= 1023.0) ? 1023 : (uint16_t)x;
+
+        if (ADCCFG & RESFMT) {
+            ADC_RES = res >> 8;
+            ADC_RESL = res & 0xFF;
+        } else {
+            ADC_RES = res >> 2;
+            ADC_RESL = (res & 0x03) << 6;
+        }
+        ADC_CONTR = (ADC_CONTR & (uint8_t)~ADC_START) | ADC_FLAG;
+        sim_adc_busy = false;
+    }
+}
+
+const sim_model_t sim_adc_model = {"adc", sim_adc_poll, sim_adc_next, sim_adc_fire, NULL};
@@ -0,0 +1,328 @@
+/**
+ * @file sim_core.c
+ * @brief 仿真器内核：虚拟时钟、函数调用钩子、外设事件调度和中断投递
+ *
+ * @date 2026-02-07
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include "STC8H.h"
+
+#define SIM_NOP_CYCLES 6  // delay_us按每微秒4个NOP标定，每个NOP折算6个时钟使延时时长与实际一致
+
+// 固件入口和中断服务函数
+int firmware_main(void);
+void Task_Pro_Handler_Callback(void);
+void Timer0_ISR(void);
+void Timer1_ISR(void);
+void uart_isr(void);
+void adc_Isr(void);
+void pwm_ic_isr(void);
+void pwmb_update_isr(void);
+
+// 寄存器存储
+volatile uint8_t sim_sfr[256];
+volatile uint8_t sim_xsfr[SIM_XSFR_SIZE];
+volatile uint16_t sim_sbuf;
+
+sim_time_t sim_now = 0;
+sim_time_t sim_end = SIM_TIME_MAX;
+uint32_t sim_call_cost = (uint32_t)SIM_US(1);
+
+// 中断源
+typedef struct {
+    const char *name;
+    void (*isr)(void);
+    volatile uint8_t *flag;  // 中断标志寄存器
+    uint8_t flag_mask;
+    volatile uint8_t *en;    // 中断使能寄存器
+    uint8_t en_mask;         // 0表示标志位与使能位逐位对应（PWM）
+    uint8_t ack_mask;        // 进入中断时硬件自动清除的标志
+    volatile uint8_t *ip;    // 优先级寄存器低位
+    volatile uint8_t *iph;   // 优先级寄存器高位
+    uint8_t ip_mask;
+} sim_irq_t;
+
+// 按中断号排列，同优先级时中断号小的先响应；I2C、SPI、INT4未建模
+static const sim_irq_t sim_irqs[] = {
+    {"Timer0", Timer0_ISR, &TCON, 0x20, &IE, 0x02, 0x20, &IP, &IPH, 0x02},
+    {"Timer1", Timer1_ISR, &TCON, 0x80, &IE, 0x08, 0x80, &IP, &IPH, 0x08},
+    {"UART", uart_isr, &SCON, 0x03, &IE, 0x10, 0x00, &IP, &IPH, 0x10},
+    {"ADC", adc_Isr, &ADC_CONTR, ADC_FLAG, &IE, 0x20, 0x00, &IP, &IPH, 0x20},
+    {"PWMA", pwm_ic_isr, &PWMA_SR1, 0xFF, &PWMA_IER, 0x00, 0x00, &IP2, &IP2H, PPWMA},
+    {"PWMB", pwmb_update_isr, &PWMB_SR1, 0xFF, &PWMB_IER, 0x00, 0x00, &IP2, &IP2H, PPWMB},
+};
+#define SIM_IRQ_NUM (sizeof(sim_irqs) / sizeof(sim_irqs[0]))
+
+// 外设模型，事件同时到期时按此顺序处理
+static const sim_model_t *const sim_models[] = {
+    &sim_timer_model, &sim_pwma_model, &sim_pwmb_model, &sim_adc_model, &sim_uart_model, &sim_iap_model,
+};
+#define SIM_MODEL_NUM (sizeof(sim_models) / sizeof(sim_models[0]))
+
+static int sim_level = -1;                // 正在服务的最高中断优先级，-1为主程序
+static sim_time_t sim_stall_cycles = 0;  // 本次钩子中需额外推进的停顿时间
+static sim_time_t sim_exit_cycles = 0;   // 函数返回钩子累计的调用开销，下一次进入钩子时推进
+static bool sim_loop_enter = false;      // 任务调度函数进入后尚未调用其他函数
+static sim_time_t sim_loop_start;        // 本轮任务调度开始时间
+static bool sim_finishing = false;
+static struct timespec sim_wall_start;
+
+// 统计
+static uint64_t sim_hooks = 0;
+static uint64_t sim_idle_skips = 0;
+static sim_time_t sim_loop_max = 0;
+static uint64_t sim_irq_count[SIM_IRQ_NUM];
+static sim_time_t sim_irq_cycles[SIM_IRQ_NUM];  // 不含被嵌套中断占用的时间
+static sim_time_t sim_irq_nested = 0;           // 当前中断执行期间嵌套中断占用的时间
+
+// 外设模型请求停顿
+void sim_stall(sim_time_t cycles) {
+    sim_stall_cycles += cycles;
+}
+
+// 最近的外设事件时间
+static sim_time_t sim_next_event(void) {
+    sim_time_t t = SIM_TIME_MAX;
+    sim_time_t n;
+    unsigned i;
+
+    for (i = 0; i < SIM_MODEL_NUM; i++) {
+        n = sim_models[i]->next();
+        if (n < t) {
+            t = n;
+        }
+    }
+    return t;
+}
+
+// 推进虚拟时间到target，依次处理期间到期的外设事件
+static void sim_run_until(sim_time_t target) {
+    sim_time_t t;
+    unsigned i;
+
+    if (target > sim_end) {
+        target = sim_end;
+    }
+    for (;;) {
+        t = sim_next_event();
+        if (t > target) {
+            break;
+        }
+        if (t > sim_now) {
+            sim_now = t;
+        }
+        for (i = 0; i < SIM_MODEL_NUM; i++) {
+            if (sim_models[i]->next() <= sim_now) {
+                sim_models[i]->fire();
+            }
+        }
+    }
+    if (target > sim_now) {
+        sim_now = target;
+    }
+    for (i = 0; i < SIM_MODEL_NUM; i++) {
+        if (sim_models[i]->sync) {
+            sim_models[i]->sync();
+        }
+    }
+    if (sim_now >= sim_end) {
+        sim_finish("到达仿真时长");
+    }
+}
+
+// 检查固件对寄存器的写入
+static void sim_poll(void) {
+    unsigned i;
+
+    for (i = 0; i < SIM_MODEL_NUM; i++) {
+        sim_models[i]->poll();
+    }
+}
+
+// 检查寄存器写入后推进cost个时钟周期
+static void sim_step(sim_time_t cost) {
+    sim_poll();
+    cost += sim_stall_cycles + sim_exit_cycles;
+    sim_stall_cycles = 0;
+    sim_exit_cycles = 0;
+    sim_run_until(sim_now + cost);
+}
+
+// 中断优先级（0~3）
+static int sim_irq_level(const sim_irq_t *irq) {
+    return ((*irq->iph & irq->ip_mask) ? 2 : 0) | ((*irq->ip & irq->ip_mask) ? 1 : 0);
+}
+
+// 可以响应的最高优先级中断，没有返回-1
+static int sim_irq_ready(void) {
+    int best = -1;
+    int best_level = sim_level;
+    int level;
+    bool pending;
+    unsigned i;
+
+    if (!EA) {
+        return -1;
+    }
+    for (i = 0; i < SIM_IRQ_NUM; i++) {
+        const sim_irq_t *irq = &sim_irqs[i];
+
+        if (irq->en_mask) {
+            pending = (*irq->flag & irq->flag_mask) && (*irq->en & irq->en_mask);
+        } else {
+            pending = (*irq->flag & *irq->en) != 0;
+        }
+        if (!pending) {
+            continue;
+        }
+        level = sim_irq_level(irq);
+        if (level > best_level) {
+            best = (int)i;
+            best_level = level;
+        }
+    }
+    return best;
+}
+
+// 投递中断：高优先级可以打断低优先级，中断服务函数中的钩子会递归投递更高优先级的中断
+static void sim_dispatch(void) {
+    int idx;
+
+    while ((idx = sim_irq_ready()) >= 0) {
+        const sim_irq_t *irq = &sim_irqs[idx];
+        int saved = sim_level;
+        sim_time_t outer = sim_irq_nested;
+        sim_time_t start = sim_now;
+        sim_time_t elapsed;
+
+        sim_level = sim_irq_level(irq);
+        sim_irq_nested = 0;
+        *irq->flag &= (uint8_t)~irq->ack_mask;
+        irq->isr();
+        sim_poll();  // 中断返回前最后的写入（如写0清除标志）在判断下一个中断之前生效
+        sim_level = saved;
+
+        elapsed = sim_now - start;
+        sim_irq_count[idx]++;
+        sim_irq_cycles[idx] += elapsed - sim_irq_nested;
+        sim_irq_nested = outer + elapsed;
+    }
+}
+
+// 函数调用钩子
+static void sim_hook(void *fn, bool enter) {
+    bool idle = false;
+
+    sim_hooks++;
+    // 函数返回只累计时间，寄存器检查和中断投递留到下一次函数进入，钩子开销减半
+    if (!enter && fn != (void *)Task_Pro_Handler_Callback) {
+        sim_exit_cycles += sim_call_cost;
+        return;
+    }
+    if (fn == (void *)Task_Pro_Handler_Callback) {
+        if (enter) {
+            sim_loop_enter = true;
+            sim_loop_start = sim_now;
+        } else if (sim_loop_enter) {
+            idle = true;  // 本轮没有任务运行，也没有中断
+        } else if (sim_now - sim_loop_start > sim_loop_max) {
+            sim_loop_max = sim_now - sim_loop_start;
+        }
+    } else {
+        sim_loop_enter = false;
+    }
+
+    sim_step(sim_call_cost);
+
+    // 主循环空转：没有可响应的中断时直接跳到下一个外设事件
+    if (idle && sim_irq_ready() < 0) {
+        sim_time_t t = sim_next_event();
+
+        if (t > sim_now) {
+            sim_idle_skips++;
+            sim_run_until(t);
+        }
+    }
+    sim_dispatch();
+}
+
+void __cyg_profile_func_enter(void *fn, void *site) {
+    (void)site;
+    sim_hook(fn, true);
+}
+
+void __cyg_profile_func_exit(void *fn, void *site) {
+    (void)site;
+    sim_hook(fn, false);
+}
+
+// _nop_()：推进一个NOP的时间
+void sim_nop(void) {
+    sim_step(SIM_NOP_CYCLES);
+    sim_dispatch();
+}
+
+// 复位外设寄存器
+void sim_reset_sfr(void) {
+    memset((void *)sim_sfr, 0, sizeof(sim_sfr));
+    memset((void *)sim_xsfr, 0, sizeof(sim_xsfr));
+    P0 = 0xFF;
+    P1 = 0xFF;
+    P2 = 0xFF;
+    P3 = 0xFF;
+    P1M1 = 0xFF;  // 上电为高阻输入
+    P3M1 = 0xFC;  // P3.0、P3.1为准双向口
+    SP = 0x07;
+    sim_sbuf = 0x100;
+    IAP_ADDRH = 0xFF;
+    IAP_ADDRL = 0xFF;
+    ADCTIM = 0x2A;
+    PWMA_ARR = 0xFFFF;
+    PWMB_ARR = 0xFFFF;
+}
+
+// 运行固件
+void sim_run(void) {
+    clock_gettime(CLOCK_MONOTONIC, &sim_wall_start);
+    firmware_main();
+    sim_finish("固件main返回");
+}
+
+// 结束仿真
+void sim_finish(const char *reason) {
+    struct timespec now;
+    double wall;
+    double virt;
+    unsigned i;
+
+    if (sim_finishing) {
+        return;
+    }
+    sim_finishing = true;
+    fflush(stdout);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    wall = (double)(now.tv_sec - sim_wall_start.tv_sec) + (now.tv_nsec - sim_wall_start.tv_nsec) / 1e9;
+    virt = (double)sim_now / SIM_FOSC;
+
+    fprintf(stderr, "[sim] 结束：%s\n", reason);
+    fprintf(stderr, "[sim] 虚拟时间 %.3f s，实际耗时 %.3f s，加速比 %.0f\n", virt, wall,
+            wall > 0 ? virt / wall : 0.0);
+    fprintf(stderr, "[sim] 函数调用钩子 %llu 次，主循环空闲跳过 %llu 次，最长一轮任务耗时 %.1f us\n",
+            (unsigned long long)sim_hooks, (unsigned long long)sim_idle_skips,
+            SIM_TO_MS(sim_loop_max) * 1000.0);
+    fprintf(stderr, "[sim] %-8s %12s %10s\n", "中断", "次数", "占用CPU");
+    for (i = 0; i < SIM_IRQ_NUM; i++) {
+        fprintf(stderr, "[sim] %-8s %12llu %9.3f%%\n", sim_irqs[i].name, (unsigned long long)sim_irq_count[i],
+                sim_now ? 100.0 * (double)sim_irq_cycles[i] / (double)sim_now : 0.0);
+    }
+    sim_uart_report();
+    sim_pwm_report();
+    sim_iap_save();
+
+    exit(0);
+}
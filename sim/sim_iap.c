@@ -0,0 +1,110 @@
+/**
+ * @file sim_iap.c
+ * @brief IAP/EEPROM模型：字节读、字节写（只能把1写成0）、扇区擦除，软件复位结束仿真
+ * @note IAP_TRIG写入0xA5后的下一次钩子执行命令，CPU停顿擦写时间；
+ *       固件的MOVC读取直接访问sim_eeprom。EEPROM镜像可从文件加载、结束时保存，用于跨次运行的掉电保持。
+ *
+ * @date 2026-02-07
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "STC8H.h"
+
+#define SIM_EEPROM_SIZE 4096         // 与bsp_eeprom.h的EEPROM_SIZE一致
+#define SIM_EEPROM_SECTOR 512
+#define SIM_IAP_WRITE_CYCLES SIM_US(40)   // 字节写入时间
+#define SIM_IAP_ERASE_CYCLES SIM_MS(4)    // 扇区擦除时间
+
+uint8_t sim_eeprom[SIM_EEPROM_SIZE];
+
+static const char *sim_iap_path = NULL;
+static uint64_t sim_iap_writes = 0;
+static uint64_t sim_iap_erases = 0;
+
+// 加载EEPROM镜像
+void sim_iap_load(const char *path) {
+    FILE *fp;
+
+    memset(sim_eeprom, 0xFF, sizeof(sim_eeprom));
+    sim_iap_path = path;
+    if (path == NULL) {
+        return;
+    }
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return;  // 首次运行，EEPROM为擦除状态
+    }
+    if (fread(sim_eeprom, 1, sizeof(sim_eeprom), fp) != sizeof(sim_eeprom)) {
+        fprintf(stderr, "%s: EEPROM镜像应为%d字节\n", path, SIM_EEPROM_SIZE);
+        exit(2);
+    }
+    fclose(fp);
+}
+
+// 保存EEPROM镜像
+void sim_iap_save(void) {
+    FILE *fp;
+
+    fprintf(stderr, "[sim] EEPROM擦除 %llu 次，写入 %llu 字节\n", (unsigned long long)sim_iap_erases,
+            (unsigned long long)sim_iap_writes);
+    if (sim_iap_path == NULL) {
+        return;
+    }
+    fp = fopen(sim_iap_path, "wb");
+    if (fp == NULL || fwrite(sim_eeprom, 1, sizeof(sim_eeprom), fp) != sizeof(sim_eeprom)) {
+        perror(sim_iap_path);
+        return;
+    }
+    fclose(fp);
+}
+
+// 执行IAP命令
+static void sim_iap_poll(void) {
+    uint16_t addr;
+
+    if (IAP_CONTR & SWRST) {
+        IAP_CONTR &= (uint8_t)~SWRST;
+        sim_finish((IAP_CONTR & SWBS) ? "软件复位到ISP" : "软件复位");
+    }
+    if (IAP_TRIG != 0xA5) {
+        return;
+    }
+    IAP_TRIG = 0;
+    if (!(IAP_CONTR & IAPEN)) {
+        return;
+    }
+
+    addr = ((uint16_t)IAP_ADDRH << 8) | IAP_ADDRL;
+    if (addr >= SIM_EEPROM_SIZE) {
+        IAP_CONTR |= CMD_FAIL;
+        return;
+    }
+    switch (IAP_CMD & 0x03) {
+    case 1:
+        IAP_DATA = sim_eeprom[addr];
+        break;
+    case 2:
+        sim_eeprom[addr] &= IAP_DATA;  // Flash只能把1写成0
+        sim_iap_writes++;
+        sim_stall(SIM_IAP_WRITE_CYCLES);
+        break;
+    case 3:
+        memset(&sim_eeprom[addr & ~(SIM_EEPROM_SECTOR - 1)], 0xFF, SIM_EEPROM_SECTOR);
+        sim_iap_erases++;
+        sim_stall(SIM_IAP_ERASE_CYCLES);
+        break;
+    default:
+        break;
+    }
+}
+
+static sim_time_t sim_iap_next(void) {
+    return SIM_TIME_MAX;
+}
+
+static void sim_iap_fire(void) {
+}
+
+const sim_model_t sim_iap_model = {"iap", sim_iap_poll, sim_iap_next, sim_iap_fire, NULL};
@@ -0,0 +1,103 @@
+/**
+ * @file sim_main.c
+ * @brief 仿真器入口：命令行参数、脚本读取
+ *
+ * @date 2026-02-07
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim.h"
+
+// 打印用法
+static void sim_usage(const char *prog) {
+    fprintf(stderr,
+            "用法：%s [-t 秒] [-w PWM输入脚本] [-a ADC电压脚本] [-o PWM输出记录] [-e EEPROM镜像] [-c 时钟数] [-n]\n"
+            "  -t  仿真时长，单位秒（默认10）\n"
+            "  -w  PWM输入波形脚本，每行：<时间ms> <输入1|2> <频率Hz> <占空比0~1000>\n"
+            "  -a  ADC电压脚本，每行：<时间ms> <通道0~15|vcc> <电压V>\n"
+            "  -o  PWM输出占空比变化记录文件\n"
+            "  -e  EEPROM镜像文件，启动时加载，结束时保存\n"
+            "  -c  每次函数调用折算的时钟周期数（默认24，即1us）\n"
+            "  -n  不从stdin读取串口接收数据\n"
+            "串口发送数据写到stdout，统计信息写到stderr。\n",
+            prog);
+}
+
+// 打开脚本文件
+FILE *sim_script_open(const char *path) {
+    FILE *fp = fopen(path, "r");
+
+    if (fp == NULL) {
+        perror(path);
+        exit(2);
+    }
+    return fp;
+}
+
+// 读取脚本的下一条有效行
+bool sim_script_line(FILE *fp, char *buf, int len, int *line_no) {
+    while (fgets(buf, len, fp)) {
+        char *p;
+
+        (*line_no)++;
+        p = strchr(buf, '#');
+        if (p) {
+            *p = '\0';
+        }
+        for (p = buf; *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'; p++) {
+        }
+        if (*p != '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    const char *eeprom = NULL;
+    double seconds = 10.0;
+    bool use_stdin = true;
+    int opt;
+
+    sim_reset_sfr();
+    while ((opt = getopt(argc, argv, "t:w:a:o:e:c:nh")) != -1) {
+        switch (opt) {
+        case 't':
+            seconds = atof(optarg);
+            break;
+        case 'w':
+            sim_pwm_load_wave(optarg);
+            break;
+        case 'a':
+            sim_adc_load_script(optarg);
+            break;
+        case 'o':
+            sim_pwm_open_log(optarg);
+            break;
+        case 'e':
+            eeprom = optarg;
+            break;
+        case 'c':
+            sim_call_cost = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            use_stdin = false;
+            break;
+        default:
+            sim_usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (seconds <= 0) {
+        sim_usage(argv[0]);
+        return 2;
+    }
+
+    sim_end = (sim_time_t)(seconds * SIM_FOSC);
+    sim_iap_load(eeprom);
+    sim_uart_open(use_stdin);
+    sim_run();
+    return 0;
+}
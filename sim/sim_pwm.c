@@ -0,0 +1,428 @@
+/**
+ * @file sim_pwm.c
+ * @brief PWMA/PWMB模型：计数器、更新事件、输入捕获、输出比较和输出占空比记录
+ * @note PWMA：波形脚本驱动P1.0(TI1)和P1.4(TI3)的电平，每个边沿按CCMRx的输入选择、CCERx的使能和极性
+ *       把计数值锁存到CCRx并置捕获标志，标志未清除时再次捕获置SR2重复捕获标志。
+ *       PWMB：CC5~CC8比较匹配置标志，CC5的OC5REF上升沿触发ADC（CR2主模式为OC5REF时）；
+ *       每个更新事件记录上一周期PWM7(D1)、PWM8(D2)的输出占空比，输出关闭时按GPIO电平记为0或1000。
+ *       SR1/SR2按写0清除建模：固件写入的0清除对应标志，写1的位保持硬件状态，读改写与直接写效果相同。
+ *       数字滤波和预装载未建模，比较值写入后立即生效。
+ *
+ * @date 2026-02-07
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "STC8H.h"
+
+#define SIM_PWM_UIF 0x01          // 更新标志
+#define SIM_PWM_CC_FLAG(k) (0x02 << (k))  // 通道k（0~3）的捕获/比较标志
+#define SIM_PWMB_MMS_MASK 0x70    // 主模式选择
+#define SIM_PWMB_MMS_OC5REF 0x40  // OC5REF作为TRGO
+
+// 状态寄存器（写0清除）：hw为硬件标志，寄存器与hw不同说明固件写入过
+typedef struct {
+    volatile uint8_t *reg;
+    uint8_t hw;
+} sim_sr_t;
+
+static sim_sr_t sim_pwma_sr1 = {&PWMA_SR1, 0};
+static sim_sr_t sim_pwma_sr2 = {&PWMA_SR2, 0};
+static sim_sr_t sim_pwmb_sr1 = {&PWMB_SR1, 0};
+
+// 计数器
+typedef struct {
+    volatile uint8_t *cr1;
+    volatile uint16_t *pscr;
+    volatile uint16_t *arr;
+    volatile uint16_t *cntr;
+    sim_sr_t *sr1;
+    bool run;
+    uint32_t tick;           // 每个计数的时钟周期数
+    uint32_t period;         // 计数周期，ARR+1
+    sim_time_t period_start;  // 本周期起点
+    sim_time_t next_upd;     // 下一次更新事件
+} sim_cnt_t;
+
+static sim_cnt_t sim_pwma = {&PWMA_CR1, &PWMA_PSCR, &PWMA_ARR, &PWMA_CNTR, &sim_pwma_sr1};
+static sim_cnt_t sim_pwmb = {&PWMB_CR1, &PWMB_PSCR, &PWMB_ARR, &PWMB_CNTR, &sim_pwmb_sr1};
+
+// 输入波形事件
+typedef struct {
+    sim_time_t t;
+    uint8_t input;  // 0：PWM1(P1.0)，1：PWM2(P1.4)
+    uint32_t freq;
+    uint16_t duty;
+} sim_wave_evt_t;
+
+// 输入波形
+typedef struct {
+    uint8_t pin_mask;      // P1中的引脚位
+    uint8_t ti;            // 输入通道TI1~TI4的下标
+    uint8_t level;
+    sim_time_t high;       // 高电平时长
+    sim_time_t low;        // 低电平时长
+    sim_time_t next_edge;  // 下一个边沿，恒定电平时为SIM_TIME_MAX
+} sim_wave_t;
+
+static sim_wave_evt_t *sim_wave_evts = NULL;
+static size_t sim_wave_num = 0;
+static size_t sim_wave_idx = 0;
+static sim_wave_t sim_waves[2] = {
+    {1 << 0, 0, 1, 0, 0, SIM_TIME_MAX},  // 无脚本时输入悬空，准双向口上拉为高电平
+    {1 << 4, 2, 1, 0, 0, SIM_TIME_MAX},
+};
+
+// PWMA捕获寄存器
+static volatile uint16_t *const sim_pwma_ccr[4] = {&PWMA_CCR1, &PWMA_CCR2, &PWMA_CCR3, &PWMA_CCR4};
+static volatile uint8_t *const sim_pwma_ccmr[4] = {&PWMA_CCMR1, &PWMA_CCMR2, &PWMA_CCMR3, &PWMA_CCMR4};
+
+// PWMB比较通道CC5~CC8
+static volatile uint16_t *const sim_pwmb_ccr[4] = {&PWMB_CCR5, &PWMB_CCR6, &PWMB_CCR7, &PWMB_CCR8};
+static uint16_t sim_pwmb_ccr_last[4];   // 上次检查时的比较值
+static sim_time_t sim_pwmb_mark[4];     // 该时间之前（含）的匹配已处理或无效
+
+// 输出记录
+static FILE *sim_pwm_log = NULL;
+static int sim_out_last[2] = {-1, -1};
+static double sim_out_acc[2];          // 占空比对时间的积分
+static sim_time_t sim_out_time = 0;    // 已积分的时间
+
+// 加载输入波形脚本
+void sim_pwm_load_wave(const char *path) {
+    FILE *fp = sim_script_open(path);
+    char buf[256];
+    int line_no = 0;
+    double t_ms;
+    unsigned input;
+    unsigned long freq;
+    unsigned duty;
+
+    while (sim_script_line(fp, buf, sizeof(buf), &line_no)) {
+        sim_wave_evt_t *e;
+
+        if (sscanf(buf, "%lf %u %lu %u", &t_ms, &input, &freq, &duty) != 4 || t_ms < 0 || input < 1 ||
+            input > 2 || duty > 1000 || freq > SIM_FOSC / 2) {
+            fprintf(stderr, "%s:%d: 格式应为 <时间ms> <输入1|2> <频率Hz> <占空比0~1000>\n", path, line_no);
+            exit(2);
+        }
+        sim_wave_evts = realloc(sim_wave_evts, (sim_wave_num + 1) * sizeof(*sim_wave_evts));
+        if (sim_wave_evts == NULL) {
+            fprintf(stderr, "内存不足\n");
+            exit(2);
+        }
+        e = &sim_wave_evts[sim_wave_num++];
+        e->t = (sim_time_t)(t_ms * (SIM_FOSC / 1000) + 0.5);
+        e->input = (uint8_t)(input - 1);
+        e->freq = (uint32_t)freq;
+        e->duty = (uint16_t)duty;
+        if (sim_wave_num > 1 && e->t < e[-1].t) {
+            fprintf(stderr, "%s:%d: 时间必须递增\n", path, line_no);
+            exit(2);
+        }
+    }
+    fclose(fp);
+}
+
+// 打开输出记录文件
+void sim_pwm_open_log(const char *path) {
+    sim_pwm_log = fopen(path, "w");
+    if (sim_pwm_log == NULL) {
+        perror(path);
+        exit(2);
+    }
+    fprintf(sim_pwm_log, "# 时间ms 通道 占空比(0~1000)\n");
+}
+
+// 计数器启停检测
+// 固件写入状态寄存器：写0的位清除，写1的位恢复为硬件状态
+static void sim_sr_poll(sim_sr_t *r) {
+    if (*r->reg != r->hw) {
+        r->hw &= *r->reg;
+        *r->reg = r->hw;
+    }
+}
+
+// 硬件置标志
+static void sim_sr_set(sim_sr_t *r, uint8_t flag) {
+    sim_sr_poll(r);
+    r->hw |= flag;
+    *r->reg = r->hw;
+}
+
+static void sim_cnt_poll(sim_cnt_t *c) {
+    bool cen = (*c->cr1 & 0x01) != 0;
+
+    if (cen && !c->run) {
+        c->run = true;
+        c->tick = (uint32_t)*c->pscr + 1;
+        c->period = (uint32_t)*c->arr + 1;
+        c->period_start = sim_now;
+        c->next_upd = sim_now + (sim_time_t)c->period * c->tick;
+    } else if (!cen && c->run) {
+        c->run = false;
+    }
+}
+
+// 当前计数值
+static uint16_t sim_cnt_value(const sim_cnt_t *c) {
+    return (uint16_t)((sim_now - c->period_start) / c->tick);
+}
+
+// 更新事件：置UIF，开始下一周期（ARR无预装载，新值从下一周期生效）
+static void sim_cnt_update(sim_cnt_t *c) {
+    sim_sr_set(c->sr1, SIM_PWM_UIF);
+    c->period_start = c->next_upd;
+    c->period = (uint32_t)*c->arr + 1;
+    c->next_upd += (sim_time_t)c->period * c->tick;
+}
+
+static void sim_cnt_sync(sim_cnt_t *c) {
+    if (c->run) {
+        *c->cntr = sim_cnt_value(c);
+    }
+}
+
+// PWMA输入捕获：输入通道ti出现边沿
+static void sim_pwma_capture(uint8_t ti, bool rising) {
+    uint8_t k;
+
+    if (!sim_pwma.run) {
+        return;
+    }
+    for (k = 0; k < 4; k++) {
+        uint8_t ccs = *sim_pwma_ccmr[k] & 0x03;
+        uint8_t ccer = (k < 2) ? PWMA_CCER1 : PWMA_CCER2;
+        uint8_t shift = (k & 1) ? 4 : 0;
+        uint8_t flag = SIM_PWM_CC_FLAG(k);
+        uint8_t src;
+
+        // CCxS：01映射到本通道输入，10映射到相邻通道输入（TI1/TI2、TI3/TI4互换）
+        if (ccs == 0x01) {
+            src = k;
+        } else if (ccs == 0x02) {
+            src = k ^ 1;
+        } else {
+            continue;
+        }
+        if (src != ti || !(ccer & (0x01 << shift))) {
+            continue;
+        }
+        if (((ccer >> shift) & 0x02) ? rising : !rising) {
+            continue;  // CCxP：0上升沿，1下降沿
+        }
+        sim_sr_poll(&sim_pwma_sr1);
+        if (sim_pwma_sr1.hw & flag) {
+            sim_sr_set(&sim_pwma_sr2, flag);  // 重复捕获
+        }
+        *sim_pwma_ccr[k] = sim_cnt_value(&sim_pwma);
+        sim_sr_set(&sim_pwma_sr1, flag);
+    }
+}
+
+// 输入电平变化
+static void sim_wave_set_level(sim_wave_t *w, uint8_t level) {
+    if (level == w->level) {
+        return;
+    }
+    w->level = level;
+    if (level) {
+        P1 |= w->pin_mask;
+    } else {
+        P1 &= (uint8_t)~w->pin_mask;
+    }
+    sim_pwma_capture(w->ti, level != 0);
+}
+
+// 应用波形事件：频率为0时为直流，占空比非0为高电平；否则从当前时刻开始输出方波
+static void sim_wave_apply(const sim_wave_evt_t *e) {
+    sim_wave_t *w = &sim_waves[e->input];
+    sim_time_t period;
+
+    if (e->freq == 0 || e->duty == 0 || e->duty == 1000) {
+        w->next_edge = SIM_TIME_MAX;
+        sim_wave_set_level(w, e->duty != 0);
+        return;
+    }
+    period = SIM_FOSC / e->freq;
+    w->high = period * e->duty / 1000;
+    if (w->high == 0) {
+        w->high = 1;
+    }
+    w->low = (period > w->high) ? period - w->high : 1;
+    // 从当前电平的相反电平开始新波形，不产生零宽度脉冲
+    sim_wave_set_level(w, !w->level);
+    w->next_edge = sim_now + (w->level ? w->high : w->low);
+}
+
+static void sim_pwma_poll(void) {
+    sim_sr_poll(&sim_pwma_sr1);
+    sim_sr_poll(&sim_pwma_sr2);
+    sim_cnt_poll(&sim_pwma);
+}
+
+static sim_time_t sim_pwma_next(void) {
+    sim_time_t n = sim_pwma.run ? sim_pwma.next_upd : SIM_TIME_MAX;
+
+    if (sim_wave_idx < sim_wave_num && sim_wave_evts[sim_wave_idx].t < n) {
+        n = sim_wave_evts[sim_wave_idx].t;
+    }
+    if (sim_waves[0].next_edge < n) {
+        n = sim_waves[0].next_edge;
+    }
+    if (sim_waves[1].next_edge < n) {
+        n = sim_waves[1].next_edge;
+    }
+    return n;
+}
+
+static void sim_pwma_fire(void) {
+    unsigned i;
+
+    if (sim_pwma.run && sim_pwma.next_upd <= sim_now) {
+        sim_cnt_update(&sim_pwma);
+    }
+    while (sim_wave_idx < sim_wave_num && sim_wave_evts[sim_wave_idx].t <= sim_now) {
+        sim_wave_apply(&sim_wave_evts[sim_wave_idx++]);
+    }
+    for (i = 0; i < 2; i++) {
+        sim_wave_t *w = &sim_waves[i];
+
+        if (w->next_edge <= sim_now) {
+            sim_wave_set_level(w, !w->level);
+            w->next_edge += w->level ? w->high : w->low;
+        }
+    }
+}
+
+static void sim_pwma_sync(void) {
+    sim_cnt_sync(&sim_pwma);
+}
+
+const sim_model_t sim_pwma_model = {"pwma", sim_pwma_poll, sim_pwma_next, sim_pwma_fire, sim_pwma_sync};
+
+// PWMB比较通道是否需要产生事件：比较中断使能，或CC5作为ADC触发源
+static bool sim_pwmb_armed(uint8_t k) {
+    if (PWMB_IER & SIM_PWM_CC_FLAG(k)) {
+        return true;
+    }
+    return k == 0 && (PWMB_CR2 & SIM_PWMB_MMS_MASK) == SIM_PWMB_MMS_OC5REF;
+}
+
+// PWMB通道k的下一次比较匹配时间
+static sim_time_t sim_pwmb_match(uint8_t k) {
+    uint16_t ccr = *sim_pwmb_ccr[k];
+    sim_time_t t;
+
+    if (!sim_pwmb.run || ccr >= sim_pwmb.period || !sim_pwmb_armed(k)) {
+        return SIM_TIME_MAX;
+    }
+    t = sim_pwmb.period_start + (sim_time_t)ccr * sim_pwmb.tick;
+    if (t <= sim_pwmb_mark[k]) {
+        t += (sim_time_t)sim_pwmb.period * sim_pwmb.tick;
+    }
+    return t;
+}
+
+// 通道输出占空比（0~1000），输出关闭时取GPIO电平
+static int sim_pwmb_output(uint8_t ch) {
+    uint8_t k = ch + 2;  // D1为CC7，D2为CC8
+    uint8_t eno = ch ? 0x40 : 0x10;
+    uint8_t ccer = ch ? 0x10 : 0x01;
+    uint16_t ccr = *sim_pwmb_ccr[k];
+
+    if ((PWMB_BKR & 0x80) && (PWMB_ENO & eno) && (PWMB_CCER2 & ccer)) {
+        if (ccr >= sim_pwmb.period) {
+            return 1000;
+        }
+        return (int)((uint32_t)ccr * 1000 / sim_pwmb.period);
+    }
+    return (P3 & (1 << (3 + ch))) ? 1000 : 0;
+}
+
+// 记录刚结束的输出周期
+static void sim_pwmb_record(sim_time_t start, sim_time_t end) {
+    uint8_t ch;
+
+    for (ch = 0; ch < 2; ch++) {
+        int duty = sim_pwmb_output(ch);
+
+        sim_out_acc[ch] += (double)duty * (double)(end - start);
+        if (duty != sim_out_last[ch]) {
+            sim_out_last[ch] = duty;
+            if (sim_pwm_log) {
+                fprintf(sim_pwm_log, "%.3f D%u %d\n", SIM_TO_MS(start), ch + 1, duty);
+            }
+        }
+    }
+    sim_out_time += end - start;
+}
+
+static void sim_pwmb_poll(void) {
+    uint8_t k;
+
+    sim_sr_poll(&sim_pwmb_sr1);
+    sim_cnt_poll(&sim_pwmb);
+    for (k = 0; k < 4; k++) {
+        // 比较值改写或通道未使用时，当前时刻之前的匹配作废
+        if (*sim_pwmb_ccr[k] != sim_pwmb_ccr_last[k] || !sim_pwmb_armed(k)) {
+            sim_pwmb_ccr_last[k] = *sim_pwmb_ccr[k];
+            sim_pwmb_mark[k] = sim_now;
+        }
+    }
+}
+
+static sim_time_t sim_pwmb_next(void) {
+    sim_time_t n = sim_pwmb.run ? sim_pwmb.next_upd : SIM_TIME_MAX;
+    sim_time_t t;
+    uint8_t k;
+
+    for (k = 0; k < 4; k++) {
+        t = sim_pwmb_match(k);
+        if (t < n) {
+            n = t;
+        }
+    }
+    return n;
+}
+
+static void sim_pwmb_fire(void) {
+    uint8_t k;
+
+    if (sim_pwmb.run && sim_pwmb.next_upd <= sim_now) {
+        sim_time_t start = sim_pwmb.period_start;
+
+        sim_cnt_update(&sim_pwmb);
+        sim_pwmb_record(start, sim_pwmb.period_start);
+    }
+    for (k = 0; k < 4; k++) {
+        if (sim_pwmb_match(k) <= sim_now) {
+            sim_pwmb_mark[k] = sim_now;
+            sim_sr_set(&sim_pwmb_sr1, SIM_PWM_CC_FLAG(k));
+            if (k == 0 && (PWMB_CR2 & SIM_PWMB_MMS_MASK) == SIM_PWMB_MMS_OC5REF) {
+                sim_adc_pwm_trigger();
+            }
+        }
+    }
+}
+
+static void sim_pwmb_sync(void) {
+    sim_cnt_sync(&sim_pwmb);
+}
+
+const sim_model_t sim_pwmb_model = {"pwmb", sim_pwmb_poll, sim_pwmb_next, sim_pwmb_fire, sim_pwmb_sync};
+
+// 打印输出统计
+void sim_pwm_report(void) {
+    if (sim_pwm_log) {
+        fclose(sim_pwm_log);
+        sim_pwm_log = NULL;
+    }
+    if (sim_out_time == 0) {
+        fprintf(stderr, "[sim] PWM输出未启动\n");
+        return;
+    }
+    fprintf(stderr, "[sim] PWM输出平均占空比 D1 %.2f%%，D2 %.2f%%\n", sim_out_acc[0] / sim_out_time / 10.0,
+            sim_out_acc[1] / sim_out_time / 10.0);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file sim_timer.c
+ * @brief Timer0/Timer1模型：模式0（16位自动重载），12T/1T由AUXR选择
+ * @note TRx置位时锁存TH/TL作为重载值，溢出时置TFx；运行中每次钩子把当前计数写回TH/TL，
+ *       固件读到的计数精度为一次钩子的时间。Timer2只作为串口波特率发生器，由串口模型读取。
+ *
+ * @date 2026-02-07
+ */
+#include "sim.h"
+#include "STC8H.h"
+
+typedef struct {
+    volatile uint8_t *th;
+    volatile uint8_t *tl;
+    uint8_t tr_mask;   // TCON中的运行位
+    uint8_t tf_mask;   // TCON中的溢出标志
+    uint8_t x12_mask;  // AUXR中的1T模式位
+    bool run;
+    uint16_t reload;
+    uint32_t div;      // 每个计数的时钟周期数
+    sim_time_t start;  // 本次重载周期的起点
+    sim_time_t ovf;    // 下一次溢出时间
+} sim_tmr_t;
+
+static sim_tmr_t sim_tmr[2] = {
+    {&TH0, &TL0, 0x10, 0x20, T0x12},
+    {&TH1, &TL1, 0x40, 0x80, T1x12},
+};
+
+// 溢出周期
+static sim_time_t sim_tmr_period(const sim_tmr_t *t) {
+    return (sim_time_t)(65536UL - t->reload) * t->div;
+}
+
+// 检测TRx变化
+static void sim_tmr_poll(void) {
+    unsigned i;
+
+    for (i = 0; i < 2; i++) {
+        sim_tmr_t *t = &sim_tmr[i];
+        bool tr = (TCON & t->tr_mask) != 0;
+
+        if (tr && !t->run) {
+            t->run = true;
+            t->reload = ((uint16_t)*t->th << 8) | *t->tl;
+            t->div = (AUXR & t->x12_mask) ? 1 : 12;
+            t->start = sim_now;
+            t->ovf = sim_now + sim_tmr_period(t);
+        } else if (!tr && t->run) {
+            t->run = false;  // 停止后TH/TL保持最后一次同步的计数
+        }
+    }
+}
+
+static sim_time_t sim_tmr_next(void) {
+    sim_time_t n = SIM_TIME_MAX;
+    unsigned i;
+
+    for (i = 0; i < 2; i++) {
+        if (sim_tmr[i].run && sim_tmr[i].ovf < n) {
+            n = sim_tmr[i].ovf;
+        }
+    }
+    return n;
+}
+
+// 溢出：置标志，重载
+static void sim_tmr_fire(void) {
+    unsigned i;
+
+    for (i = 0; i < 2; i++) {
+        sim_tmr_t *t = &sim_tmr[i];
+
+        if (t->run && t->ovf <= sim_now) {
+            TCON |= t->tf_mask;
+            t->start = t->ovf;
+            t->ovf += sim_tmr_period(t);
+        }
+    }
+}
+
+// 当前计数写回TH/TL
+static void sim_tmr_sync(void) {
+    unsigned i;
+
+    for (i = 0; i < 2; i++) {
+        sim_tmr_t *t = &sim_tmr[i];
+
+        if (t->run) {
+            uint16_t cnt = (uint16_t)(t->reload + (sim_now - t->start) / t->div);
+
+            *t->th = cnt >> 8;
+            *t->tl = cnt & 0xFF;
+        }
+    }
+}
+
+const sim_model_t sim_timer_model = {"timer", sim_tmr_poll, sim_tmr_next, sim_tmr_fire, sim_tmr_sync};
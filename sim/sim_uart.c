@@ -0,0 +1,126 @@
+/**
+ * @file sim_uart.c
+ * @brief UART1模型：发送写到stdout，stdin的数据按波特率逐字节送入SBUF
+ * @note 波特率由Timer2重载值计算（模式1，波特率 = SYSclk/分频/(65536-重载值)/4）。
+ *       固件发送后轮询busy等待下一个字节，轮询循环中没有函数调用、无法推进虚拟时间，
+ *       因此写SBUF时CPU停顿一个字节时间后立即置TI，发送总时长与硬件一致。
+ *       接收每1ms（虚拟时间）非阻塞读取一次stdin，RI未清除时暂缓送入下一个字节，不产生溢出。
+ *
+ * @date 2026-02-07
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "STC8H.h"
+
+#define SIM_UART_RX_BUF 256            // 接收缓冲（2的幂）
+#define SIM_UART_POLL SIM_MS(1)        // stdin读取间隔
+#define SIM_UART_TI 0x02
+#define SIM_UART_RI 0x01
+#define SIM_UART_REN 0x10
+
+static uint8_t sim_rx_buf[SIM_UART_RX_BUF];
+static unsigned sim_rx_head = 0;
+static unsigned sim_rx_tail = 0;
+static bool sim_rx_open = false;          // stdin可读
+static int sim_rx_flags = -1;             // stdin原来的文件状态标志，结束时恢复
+static sim_time_t sim_rx_poll_t = 0;      // 下一次读取stdin
+static sim_time_t sim_rx_next_t = 0;      // 下一个字节最早送入时间
+static uint8_t sim_rx_last = 0;
+static uint64_t sim_tx_bytes = 0;
+static uint64_t sim_rx_bytes = 0;
+
+// 一个字节（10位）的时钟周期数
+static sim_time_t sim_uart_byte_cycles(void) {
+    uint16_t reload = ((uint16_t)T2H << 8) | T2L;
+    uint32_t div = (AUXR & T2x12) ? 1 : 12;
+
+    return (sim_time_t)(65536UL - reload) * div * 4 * 10;
+}
+
+// 打开stdin作为接收数据源
+void sim_uart_open(bool use_stdin) {
+    if (!use_stdin) {
+        return;
+    }
+    sim_rx_flags = fcntl(STDIN_FILENO, F_GETFL);
+    if (sim_rx_flags < 0) {
+        return;
+    }
+    fcntl(STDIN_FILENO, F_SETFL, sim_rx_flags | O_NONBLOCK);
+    sim_rx_open = true;
+}
+
+// 非阻塞读取stdin
+static void sim_uart_read_stdin(void) {
+    uint8_t buf[SIM_UART_RX_BUF];
+    unsigned space = SIM_UART_RX_BUF - 1 - ((sim_rx_head - sim_rx_tail) & (SIM_UART_RX_BUF - 1));
+    ssize_t n;
+    ssize_t i;
+
+    if (space == 0) {
+        return;
+    }
+    n = read(STDIN_FILENO, buf, space);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        sim_rx_open = false;  // 输入结束，之后不再读取
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        sim_rx_buf[sim_rx_head] = buf[i];
+        sim_rx_head = (sim_rx_head + 1) & (SIM_UART_RX_BUF - 1);
+    }
+}
+
+// 检测SBUF写入
+static void sim_uart_poll(void) {
+    if (sim_sbuf < 0x100) {
+        putchar((uint8_t)sim_sbuf);
+        sim_tx_bytes++;
+        sim_sbuf = 0x100 | sim_rx_last;
+        SCON |= SIM_UART_TI;
+        sim_stall(sim_uart_byte_cycles());
+    }
+}
+
+// 是否可以送入下一个接收字节
+static bool sim_uart_rx_ready(void) {
+    return sim_rx_head != sim_rx_tail && (SCON & SIM_UART_REN) && !(SCON & SIM_UART_RI);
+}
+
+static sim_time_t sim_uart_next(void) {
+    sim_time_t n = sim_rx_open ? sim_rx_poll_t : SIM_TIME_MAX;
+
+    if (sim_uart_rx_ready() && sim_rx_next_t < n) {
+        n = sim_rx_next_t;
+    }
+    return n;
+}
+
+static void sim_uart_fire(void) {
+    if (sim_rx_open && sim_rx_poll_t <= sim_now) {
+        sim_uart_read_stdin();
+        sim_rx_poll_t = sim_now + SIM_UART_POLL;
+    }
+    if (sim_uart_rx_ready() && sim_rx_next_t <= sim_now) {
+        sim_rx_last = sim_rx_buf[sim_rx_tail];
+        sim_rx_tail = (sim_rx_tail + 1) & (SIM_UART_RX_BUF - 1);
+        sim_sbuf = 0x100 | sim_rx_last;
+        SCON |= SIM_UART_RI;
+        sim_rx_next_t = sim_now + sim_uart_byte_cycles();
+        sim_rx_bytes++;
+    }
+}
+
+const sim_model_t sim_uart_model = {"uart", sim_uart_poll, sim_uart_next, sim_uart_fire, NULL};
+
+// 打印收发统计，恢复stdin
+void sim_uart_report(void) {
+    if (sim_rx_flags >= 0) {
+        fcntl(STDIN_FILENO, F_SETFL, sim_rx_flags);
+    }
+    fprintf(stderr, "[sim] 串口发送 %llu 字节，接收 %llu 字节\n", (unsigned long long)sim_tx_bytes,
+            (unsigned long long)sim_rx_bytes);
+}
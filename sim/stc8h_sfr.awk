@@ -0,0 +1,69 @@
+# 由User/STC8H.H生成仿真用STC8H.h：寄存器定义改为访问sim_sfr.h中的存储，其余宏原样保留
+# 用法：awk -f stc8h_sfr.awk User/STC8H.H > STC8H.h
+
+# 把s中所有匹配re的寄存器访问表达式替换为fmt，fmt中的%s为寄存器地址
+function repl(s, re, fmt,    out, expr, start, len) {
+    out = ""
+    while (match(s, re)) {
+        start = RSTART
+        len = RLENGTH
+        expr = substr(s, start, len)
+        match(expr, /0x[0-9a-fA-F]+/)
+        out = out substr(s, 1, start - 1) sprintf(fmt, substr(expr, RSTART, RLENGTH))
+        s = substr(s, start + len)
+    }
+    return out s
+}
+
+{
+    sub(/\r$/, "")
+}
+
+# Keil库头文件由sim_keil.h代替
+/^#include/ {
+    next
+}
+
+/^#define[ \t]+__STC8H_H__/ {
+    print
+    print "#include \"sim_sfr.h\""
+    next
+}
+
+# sfr NAME = 0xNN;
+/^[ \t]*sfr[ \t]/ {
+    name = $2
+    addr = $4
+    sub(/;.*/, "", addr)
+    sfr[name] = addr
+    if (name == "SBUF") {
+        printf "#define %-16s sim_sbuf\n", name
+    } else {
+        printf "#define %-16s SIM_SFR(%s)\n", name, addr
+    }
+    next
+}
+
+# sbit NAME = REG^n;
+/^[ \t]*sbit[ \t]/ {
+    name = $2
+    split($4, f, "^")
+    reg = f[1]
+    n = f[2]
+    sub(/;.*/, "", n)
+    if (!(reg in sfr)) {
+        printf "stc8h_sfr.awk: 未知寄存器 %s\n", reg > "/dev/stderr"
+        exit 1
+    }
+    printf "    #define %-12s SIM_SBIT(%s, %s)\n", name, sfr[reg], n
+    next
+}
+
+# 扩展SFR：8位、16位寄存器和CHIPID指针
+{
+    line = $0
+    line = repl(line, "\\(\\*\\(unsigned[ \t]+char[ \t]+volatile[ \t]+xdata[ \t]+\\*\\)0x[0-9a-fA-F]+\\)", "SIM_XSFR8(%s)")
+    line = repl(line, "\\(\\*\\(unsigned[ \t]+int[ \t]+volatile[ \t]+xdata[ \t]+\\*\\)0x[0-9a-fA-F]+\\)", "SIM_XSFR16(%s)")
+    line = repl(line, "\\([ \t]*\\(unsigned[ \t]+char[ \t]+volatile[ \t]+xdata[ \t]+\\*\\)0x[0-9a-fA-F]+\\)", "(&SIM_XSFR8(%s))")
+    print line
+}
@@ -0,0 +1,67 @@
+#!/bin/sh
+# 主机测试：编译运行sim/tests下的单元测试
+# 用法：sh sim/test.sh [输出目录]，默认输出到sim/out；任一测试失败时返回非0
+# 单元测试之后构建仿真器，运行sim/scripts下的场景检查输出记录
+# 环境变量：CC 编译器（默认cc），SIM_CFLAGS 附加编译选项
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${1:-$ROOT/sim/out}
+CC=${CC:-cc}
+
+mkdir -p "$OUT/test"
+
+COMMON="-std=gnu99 -O2 -g -fno-strict-aliasing -Wall -Wno-unused-function -Wno-unknown-pragmas $SIM_CFLAGS"
+INC="-I$ROOT/sim/include -I$ROOT/User -I$ROOT/Drivers"
+
+# 滤波库
+$CC $COMMON -include "$ROOT/sim/include/sim_keil.h" $INC \
+    "$ROOT/User/filter.c" "$ROOT/sim/tests/filter_test.c" -o "$OUT/test/filter_test"
+"$OUT/test/filter_test"
+
+# 固件仿真回归：输入阶跃和信号丢失，检查输出记录；再用保存的EEPROM镜像重启，检查上电恢复
+sh "$ROOT/sim/build.sh" "$OUT" >/dev/null
+SIM="$OUT/gl08_sim"
+rm -f "$OUT/test/ee.bin"
+"$SIM" -t 6 -w "$ROOT/sim/scripts/pwm_step.txt" -a "$ROOT/sim/scripts/knobs_ext.txt" \
+    -o "$OUT/test/step.log" -e "$OUT/test/ee.bin" -n >/dev/null 2>"$OUT/test/step.err"
+
+# 取每个通道在给定时刻的输出值（该时刻之前最后一条记录）
+sim_duty() {
+    awk -v ch="$1" -v t="$2" '!/^#/ && $2 == ch && $1 <= t { v = $3 } END { print v + 0 }' "$3"
+}
+
+sim_check() {
+    if [ "$2" -ge "$3" ] && [ "$2" -le "$4" ]; then
+        echo "$1 = $2"
+    else
+        echo "$1 = $2，应在 $3~$4 之间" >&2
+        SIM_FAILED=1
+    fi
+}
+
+SIM_FAILED=0
+sim_check "D1@900ms（输入30%）" "$(sim_duty D1 900 "$OUT/test/step.log")" 290 310
+sim_check "D2@900ms（输入60%）" "$(sim_duty D2 900 "$OUT/test/step.log")" 590 610
+sim_check "D1@1030ms（1000ms阶跃到80%，外部跟踪不经渐变）" "$(sim_duty D1 1030 "$OUT/test/step.log")" 790 810
+sim_check "D2@2010ms（2000ms断线恒低，回退不经渐变）" "$(sim_duty D2 2010 "$OUT/test/step.log")" 0 0
+
+# 本地旋钮变化经渐变引擎限速：1000ms波段0%→100%，2000ms功率100%→83%，3000ms拨回EXT档
+"$SIM" -t 4 -w "$ROOT/sim/scripts/pwm_step.txt" -a "$ROOT/sim/scripts/knobs_step.txt" \
+    -o "$OUT/test/knob.log" -n >/dev/null 2>"$OUT/test/knob.err"
+sim_check "D1@1200ms（波段0%→100%渐变中）" "$(sim_duty D1 1200 "$OUT/test/knob.log")" 200 450
+sim_check "D1@1600ms（渐变完成）" "$(sim_duty D1 1600 "$OUT/test/knob.log")" 1000 1000
+sim_check "D1@2050ms（功率100%→83%渐变中）" "$(sim_duty D1 2050 "$OUT/test/knob.log")" 900 990
+sim_check "D1@3600ms（EXT档80%×83%）" "$(sim_duty D1 3600 "$OUT/test/knob.log")" 656 676
+
+# 第一条记录（1ms之前）即为恢复的掉电前状态
+"$SIM" -t 1 -a "$ROOT/sim/scripts/knobs_ext.txt" -o "$OUT/test/restore.log" -e "$OUT/test/ee.bin" \
+    -n >/dev/null 2>"$OUT/test/restore.err"
+sim_check "D1上电恢复" "$(sim_duty D1 1 "$OUT/test/restore.log")" 790 810
+sim_check "D2上电恢复" "$(sim_duty D2 1 "$OUT/test/restore.log")" 0 0
+
+if [ "$SIM_FAILED" -ne 0 ]; then
+    echo "仿真回归失败" >&2
+    exit 1
+fi
+echo "仿真回归通过"
@@ -0,0 +1,361 @@
+/**
+ * @file filter_test.c
+ * @brief 滤波库主机测试：与旧ewma_filter_update对比输出，各类型与逐点参考实现对比，测量每次更新耗时
+ * @note 由sim/test.sh编译运行，失败时返回非0。耗时为主机上的相对值，只用于比较各算法和新旧实现。
+ *
+ * @date 2026-02-07
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "filter.h"
+
+static int test_failed = 0;
+
+#define TEST_CHECK(cond, ...)                                  \
+    do {                                                       \
+        if (!(cond)) {                                         \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);    \
+            fprintf(stderr, __VA_ARGS__);                      \
+            fprintf(stderr, "\n");                             \
+            test_failed++;                                     \
+        }                                                      \
+    } while (0)
+
+// 可复现的伪随机数
+static uint32_t test_seed = 1;
+
+static int test_rand(int range) {
+    test_seed = test_seed * 1103515245u + 12345u;
+    return (int)((test_seed >> 16) % (uint32_t)range);
+}
+
+/* ---------- 旧实现：原filter.c中的ewma_filter_init/ewma_filter_update，用于对比 ---------- */
+// 以下结构体和两个函数逐字复制自原实现，只加了static。主机int为32位，均值乘(n-1)的中间结果按int计算；
+// C51上按16位无符号计算，样本不超过1023、n≤64时中间结果小于65536，两者结果相同
+
+typedef struct {
+    uint16_t ave;      // 唯一维护的变量：滤波平均值
+    uint16_t n;        // 滤波长度N（可动态调整，无需重启）
+    bool is_first; // 新增：标记是否第一次采样
+} ewma_filter_t;
+
+static void ewma_filter_init(bool en, uint16_t init_val, uint16_t n, ewma_filter_t* pFilter) {
+  if(!en || pFilter == NULL || n <= 0) return;
+  pFilter->ave = init_val;  // 第一次采样直接赋值（符合你说的初始逻辑）
+  pFilter->n = n;
+  pFilter->is_first = true;
+}
+
+static uint16_t ewma_filter_update(bool en, uint16_t sample, uint16_t die, uint16_t max_err,
+                        ewma_filter_t* pFilter) {
+  uint16_t err;
+  uint16_t n;
+
+  // 入参合法性检查
+  if(!en || pFilter == NULL || pFilter->n <= 0 || max_err < die) {
+    return pFilter->ave;
+  }
+
+  // 核心修复：第一次采样强制赋值，避免初始0导致限幅死循环
+  if(pFilter->is_first) {
+    pFilter->ave = sample;
+    pFilter->is_first = false;
+    return sample;
+  }
+
+  // 限幅滤波（防极端干扰）
+  err = abs((int16_t)sample - (int16_t)pFilter->ave);
+  if(err > max_err) {
+    return pFilter->ave;  // 丢弃异常值，沿用旧平均值
+  }
+
+  // 死区判断（平衡平滑与响应）
+  if(err > die) {
+    // 死区外：快速响应，直接更新平均值
+    pFilter->ave = sample;
+  } else {
+    // 死区内：加权平均滤波（核心公式，仅1个变量）
+    n = pFilter->n;
+    pFilter->ave = (pFilter->ave * (n - 1) + sample) / n;
+  }
+
+  return pFilter->ave;
+}
+
+/* ---------- 输入序列 ---------- */
+
+#define TEST_LEN 20000
+
+// 平稳段加±3噪声、阶跃（50~400）、缓慢斜坡和孤立的大幅异常值。
+// 噪声加上旧实现的截断偏差小于死区，阶跃大于死区、小于限幅阈值，两种实现的门限判断一致
+static void test_make_input(uint16_t *in, int len) {
+    int level = 500;
+    int i;
+
+    for (i = 0; i < len; i++) {
+        int v;
+
+        if (i % 2000 == 0) {
+            int step = 50 + test_rand(351);  // 阶跃
+            level = (level + step <= 950 && (test_rand(2) || level - step < 50)) ? level + step : level - step;
+        } else if (i % 2000 >= 1500 && level < 950) {
+            level += (i & 1);  // 斜坡，每2个样本加1
+        }
+        v = level + test_rand(7) - 3;
+        if (test_rand(500) == 0) {
+            v = (v > 510) ? v - 510 : v + 510;  // 异常值，偏差大于限幅阈值，仍在样本范围内
+        }
+        in[i] = (uint16_t)v;
+    }
+}
+
+/* ---------- 测试 ---------- */
+
+// 新EWMA(k=2)与旧实现(N=4)对比：门限行为一致；旧实现整数除法截断，向上逼近时最多停在样本下方N-1处
+static void test_ewma_vs_legacy(const uint16_t *in) {
+    filter_t f;
+    ewma_filter_t old;
+    double ideal = 0;
+    int max_old = 0;
+    int max_ideal = 0;
+    int i;
+
+    filter_init(&f, FILTER_EWMA, 2, 10, 500, NULL);
+    ewma_filter_init(true, 0, 4, &old);
+
+    for (i = 0; i < TEST_LEN; i++) {
+        int a = filter_update(&f, in[i]);
+        int b = ewma_filter_update(true, in[i], 10, 500, &old);
+        int err = abs((int)in[i] - (int)ideal);
+        int d;
+
+        // 理想浮点EWMA，门限与新实现相同
+        if (i == 0 || (err <= 500 && err > 10)) {
+            ideal = in[i];
+        } else if (err <= 10) {
+            ideal += (in[i] - ideal) / 4;
+        }
+
+        d = abs(a - b);
+        if (d > max_old) max_old = d;
+        d = abs(a - (int)(ideal + 0.5));
+        if (d > max_ideal) max_ideal = d;
+        TEST_CHECK(abs(a - b) <= 3, "EWMA[%d] 新%d 旧%d 差值超过旧实现的截断误差", i, a, b);
+    }
+    TEST_CHECK(max_ideal <= 1, "EWMA与理想浮点实现最大差值%d", max_ideal);
+    printf("EWMA   与旧实现最大差值 %d，与理想浮点实现最大差值 %d\n", max_old, max_ideal);
+}
+
+// MA与逐点计算的窗口平均对比（不启用门限）
+static void test_ma(const uint16_t *in) {
+    static uint16_t xdata buf[FILTER_MA_WIN_MAX];
+    filter_t f;
+    uint8_t k;
+    int i;
+
+    for (k = 1; k <= 3; k++) {
+        int n = 1 << k;
+
+        filter_init(&f, FILTER_MA, k, 0, 0, buf);
+        for (i = 0; i < TEST_LEN; i++) {
+            uint32_t sum = 0;
+            int j;
+            int a = filter_update(&f, in[i]);
+
+            for (j = 0; j < n; j++) {
+                sum += in[(i - j < 0) ? 0 : i - j];
+            }
+            TEST_CHECK(a == (int)(sum >> k), "MA k=%u [%d] %d 应为%u", k, i, a, (unsigned)(sum >> k));
+        }
+    }
+}
+
+// 中值与逐点排序结果对比（不启用门限）
+static void test_median(const uint16_t *in) {
+    static uint16_t xdata buf[FILTER_MEDIAN_WIN_MAX];
+    filter_t f;
+    uint8_t n;
+    int i;
+
+    for (n = 3; n <= 5; n += 2) {
+        filter_init(&f, FILTER_MEDIAN, n, 0, 0, buf);
+        for (i = 0; i < TEST_LEN; i++) {
+            uint16_t w[FILTER_MEDIAN_WIN_MAX];
+            int j;
+            int m;
+            int a = filter_update(&f, in[i]);
+
+            for (j = 0; j < n; j++) {
+                w[j] = in[(i - j < 0) ? 0 : i - j];
+            }
+            for (j = 1; j < n; j++) {
+                for (m = j; m > 0 && w[m - 1] > w[m]; m--) {
+                    uint16_t t = w[m];
+                    w[m] = w[m - 1];
+                    w[m - 1] = t;
+                }
+            }
+            TEST_CHECK(a == w[n >> 1], "MEDIAN n=%u [%d] %d 应为%u", n, i, a, w[n >> 1]);
+        }
+    }
+}
+
+// 样本超过上限按上限处理，16位定点不溢出
+static void test_sample_limit(void) {
+    filter_t f;
+    int i;
+
+    filter_init(&f, FILTER_EWMA, 1, 0, 0, NULL);
+    filter_update(&f, 0);
+    for (i = 0; i < 100; i++) {
+        filter_update(&f, 0xFFFF);
+    }
+    TEST_CHECK(filter_get(&f) == FILTER_SAMPLE_MAX, "EWMA上限 %u", filter_get(&f));
+
+    filter_init(&f, FILTER_ALPHA_BETA, 3, 10, 0, NULL);
+    filter_update(&f, 0);
+    for (i = 0; i < 100; i++) {
+        filter_update(&f, FILTER_SAMPLE_MAX);
+    }
+    TEST_CHECK(filter_get(&f) == FILTER_SAMPLE_MAX, "ALPHA_BETA上限 %u", filter_get(&f));
+}
+
+// α-β阶跃：不过冲，几次更新内进入死区
+static void test_ab_step(void) {
+    static const uint16_t steps[][2] = {{300, 800}, {800, 300}, {409, 600}, {0, 1023}, {500, 520}};
+    filter_t f;
+    int n;
+    int i;
+
+    for (n = 0; n < (int)(sizeof(steps) / sizeof(steps[0])); n++) {
+        uint16_t from = steps[n][0];
+        uint16_t to = steps[n][1];
+        int settle = -1;
+
+        filter_init(&f, FILTER_ALPHA_BETA, 3, 10, 500, NULL);
+        filter_update(&f, from);
+        for (i = 0; i < 100; i++) {
+            int a = filter_update(&f, to);
+
+            TEST_CHECK((to > from) ? a <= to : a >= to, "ALPHA_BETA %u->%u [%d] %d 过冲", from, to, i, a);
+            if (settle < 0 && abs(a - (int)to) <= 10) settle = i;
+        }
+        TEST_CHECK(settle >= 0 && settle <= 5, "ALPHA_BETA %u->%u 第%d次进入死区", from, to, settle);
+        TEST_CHECK(abs((int)filter_get(&f) - (int)to) <= 1, "ALPHA_BETA %u->%u 稳态%u", from, to, filter_get(&f));
+    }
+}
+
+// α-β斜坡：每次+2的斜坡稳态滞后小，斜坡结束后不过冲
+static void test_ab_ramp(void) {
+    filter_t f;
+    int max_lag = 0;
+    int i;
+
+    filter_init(&f, FILTER_ALPHA_BETA, 3, 10, 500, NULL);
+    filter_update(&f, 200);
+    for (i = 1; i <= 200; i++) {
+        int a = filter_update(&f, 200 + 2 * i);
+
+        if (i > 20 && abs(200 + 2 * i - a) > max_lag) max_lag = abs(200 + 2 * i - a);
+    }
+    TEST_CHECK(max_lag <= 10, "ALPHA_BETA 斜坡滞后%d", max_lag);
+    for (i = 0; i < 100; i++) {
+        int a = filter_update(&f, 600);
+
+        TEST_CHECK(a <= 600, "ALPHA_BETA 斜坡结束[%d] %d 过冲", i, a);
+    }
+}
+
+// α-β噪声：平稳段±5噪声的输出方差明显小于输入方差
+static void test_ab_noise(void) {
+    filter_t f;
+    double in_var = 0;
+    double out_var = 0;
+    int i;
+
+    filter_init(&f, FILTER_ALPHA_BETA, 3, 10, 500, NULL);
+    filter_update(&f, 500);
+    for (i = 0; i < TEST_LEN; i++) {
+        int v = 500 + test_rand(11) - 5;
+        int a = filter_update(&f, v);
+
+        in_var += (v - 500) * (v - 500);
+        out_var += (a - 500) * (a - 500);
+    }
+    TEST_CHECK(out_var * 4 < in_var, "ALPHA_BETA 噪声方差 输入%.2f 输出%.2f", in_var / TEST_LEN, out_var / TEST_LEN);
+    printf("ALPHA_BETA 噪声方差 输入%.2f 输出%.2f\n", in_var / TEST_LEN, out_var / TEST_LEN);
+}
+
+/* ---------- 耗时 ---------- */
+
+#define BENCH_ROUNDS 200
+
+static double bench_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static volatile uint16_t bench_sink;
+
+// 每次更新的平均耗时，单位ns
+static double bench_filter(filter_type_t type, uint8_t k, const uint16_t *in) {
+    static uint16_t xdata buf[FILTER_MA_WIN_MAX];
+    filter_t f;
+    double t0;
+    int r;
+    int i;
+
+    filter_init(&f, type, k, 10, 500, buf);
+    t0 = bench_now();
+    for (r = 0; r < BENCH_ROUNDS; r++) {
+        for (i = 0; i < TEST_LEN; i++) {
+            bench_sink = filter_update(&f, in[i]);
+        }
+    }
+    return (bench_now() - t0) * 1e9 / ((double)BENCH_ROUNDS * TEST_LEN);
+}
+
+static double bench_legacy(const uint16_t *in) {
+    ewma_filter_t old;
+    double t0;
+    int r;
+    int i;
+
+    ewma_filter_init(true, 0, 4, &old);
+    t0 = bench_now();
+    for (r = 0; r < BENCH_ROUNDS; r++) {
+        for (i = 0; i < TEST_LEN; i++) {
+            bench_sink = ewma_filter_update(true, in[i], 10, 500, &old);
+        }
+    }
+    return (bench_now() - t0) * 1e9 / ((double)BENCH_ROUNDS * TEST_LEN);
+}
+
+int main(void) {
+    static uint16_t in[TEST_LEN];
+
+    test_make_input(in, TEST_LEN);
+
+    test_ewma_vs_legacy(in);
+    test_ma(in);
+    test_median(in);
+    test_sample_limit();
+    test_ab_step();
+    test_ab_ramp();
+    test_ab_noise();
+
+    printf("每次更新耗时（主机，ns）：旧EWMA %.1f，EWMA %.1f，MA %.1f，MEDIAN5 %.1f，ALPHA_BETA %.1f\n",
+           bench_legacy(in), bench_filter(FILTER_EWMA, 2, in), bench_filter(FILTER_MA, 3, in),
+           bench_filter(FILTER_MEDIAN, 5, in), bench_filter(FILTER_ALPHA_BETA, 3, in));
+
+    if (test_failed) {
+        printf("滤波测试失败 %d 项\n", test_failed);
+        return 1;
+    }
+    printf("滤波测试通过\n");
+    return 0;
+}